@@ -15,8 +15,9 @@ class CircleTarget : public FixationTarget
   public:
     CircleTarget(unsigned int diameter);
 
-    // draw the target at pixel location (x, y)
-    void drawOpenGL(unsigned int x, unsigned int y);
+  protected:
+    // draw the target centred on (0, 0)
+    void buildOpenGL();
 };
 
 #endif // not defined CIRCLETARGET_H
\ No newline at end of file
@@ -19,17 +19,17 @@ private:
     static const unsigned int targetRatio = 3;
     unsigned int getOuterDiameter(void) const;
 
-    // helper function
-    static void drawCircleOpenGL(unsigned int x, unsigned int y,
-                                 unsigned int diameter);
+    // helper function - draw a circle centred on (0, 0)
+    static void drawCircleOpenGL(unsigned int diameter);
 
   public:
     // diameter in this case refers to the size of the inner circle of the
     // target, and the width of the crosshair lines
     CrosshairBullseyeTarget(unsigned int diameter);
 
-    // draw the target at pixel location (x, y)
-    void drawOpenGL(unsigned int x, unsigned int y);
+  protected:
+    // draw the target centred on (0, 0)
+    void buildOpenGL();
 };
 
 #endif // not defined CROSSHAIRBULLSEYETARGET_H
@@ -0,0 +1,68 @@
+// Cached display geometry.
+
+#include "DisplayGeometry.h"
+
+#include "common.h"
+
+PixelTransform::PixelTransform(unsigned int width, unsigned int height)
+    : xScale(width > 0 ? 2.0 / static_cast<double>(width) : 0.0),
+      yScale(height > 0 ? 2.0 / static_cast<double>(height) : 0.0)
+{}
+
+DisplayGeometry::DisplayGeometry()
+    : known(false), resolution(0, 0), transform(0, 0), generation(0)
+{}
+
+DisplayGeometry &DisplayGeometry::get()
+{
+    static DisplayGeometry inst;
+    return inst;
+}
+
+void DisplayGeometry::resolve()
+{
+    if (!known)
+    {
+        resolution = common::getScreenRes();
+        transform = PixelTransform(resolution.first, resolution.second);
+        known = true;
+    }
+}
+
+std::pair<unsigned int, unsigned int> DisplayGeometry::getResolution()
+{
+    std::lock_guard<std::mutex> lock(geometryMutex);
+    resolve();
+    return resolution;
+}
+
+PixelTransform DisplayGeometry::getPixelTransform()
+{
+    std::lock_guard<std::mutex> lock(geometryMutex);
+    resolve();
+    return transform;
+}
+
+void DisplayGeometry::setResolution(std::pair<unsigned int, unsigned int> res)
+{
+    std::lock_guard<std::mutex> lock(geometryMutex);
+    if (!known || res != resolution)
+    {
+        resolution = res;
+        transform = PixelTransform(res.first, res.second);
+        known = true;
+        ++generation;
+    }
+}
+
+void DisplayGeometry::invalidate()
+{
+    std::lock_guard<std::mutex> lock(geometryMutex);
+    known = false;
+    ++generation;
+}
+
+std::uint64_t DisplayGeometry::getGeneration() const
+{
+    return generation;
+}
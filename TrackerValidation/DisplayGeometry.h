@@ -0,0 +1,89 @@
+// Cached display geometry.
+// Looking up the screen resolution is slow (on X11 it opens a new connection
+// to the display every time), but it hardly ever changes. DisplayGeometry
+// looks it up once, and hands out the resolution and the pixel to OpenGL
+// position transform from then on. The UI tells it when the window has been
+// resized (e.g. moved to another monitor), so it is looked up again.
+
+#ifndef DISPLAYGEOMETRY_H
+#define DISPLAYGEOMETRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility> // for std::pair
+
+// Converts pixel locations to OpenGL relative positions [-1.0, 1.0] for a
+// given resolution.
+class PixelTransform
+{
+  private:
+    double xScale;
+    double yScale;
+
+  public:
+    PixelTransform(unsigned int width, unsigned int height);
+
+    // OpenGL position change for each pixel
+    inline double getXScale() const
+    {
+        return xScale;
+    }
+
+    inline double getYScale() const
+    {
+        return yScale;
+    }
+
+    // note: pixel positions can be negative - we may want to draw a object
+    //       which is partially off screen
+    inline std::pair<double, double> toPosition(int xPixel, int yPixel) const
+    {
+        // 2 x (actual_pixel_value / max_pixel_value) - 1 for each axis, with
+        // y going up the screen
+        return std::make_pair(xScale * static_cast<double>(xPixel) - 1.0,
+                              1.0 - yScale * static_cast<double>(yPixel));
+    }
+};
+
+class DisplayGeometry
+{
+  private:
+    std::mutex geometryMutex;
+    bool known;
+    std::pair<unsigned int, unsigned int> resolution;
+    PixelTransform transform;
+
+    // bumped whenever the geometry changes
+    std::atomic<std::uint64_t> generation;
+
+    DisplayGeometry();
+
+    // look up the resolution if we don't know it
+    // must be called with geometryMutex held
+    void resolve();
+
+  public:
+    // the display the validator is shown on
+    static DisplayGeometry &get();
+
+    DisplayGeometry(const DisplayGeometry &) = delete;
+    DisplayGeometry &operator=(const DisplayGeometry &) = delete;
+
+    // @throws std::runtime_error if the resolution could not be found
+    std::pair<unsigned int, unsigned int> getResolution();
+    PixelTransform getPixelTransform();
+
+    // Use this resolution rather than looking it up.
+    void setResolution(std::pair<unsigned int, unsigned int> res);
+
+    // The display may have changed - look the resolution up again when it's
+    // next needed.
+    void invalidate();
+
+    // Changes whenever the geometry might have, so anything derived from it
+    // can be cached until then.
+    std::uint64_t getGeneration() const;
+};
+
+#endif // not defined DISPLAYGEOMETRY_H
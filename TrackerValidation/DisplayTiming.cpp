@@ -0,0 +1,125 @@
+// Display timing: when targets actually appear on the screen.
+
+#include "DisplayTiming.h"
+
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+LatencyHistogram::LatencyHistogram(std::size_t maxLatency)
+    : bins(maxLatency + 1, 0), count(0), total(0.0), minimum(0.0), maximum(0.0)
+{
+    if (maxLatency == 0)
+    {
+        throw std::runtime_error("Latency histogram needs at least one bin");
+    }
+}
+
+void LatencyHistogram::add(double latency)
+{
+    // a negative latency is a clock glitch - count it as none
+    if (latency < 0.0)
+    {
+        latency = 0.0;
+    }
+
+    const std::size_t last = bins.size() - 1;
+    const std::size_t bin = (latency >= static_cast<double>(last)
+                             ? last : static_cast<std::size_t>(latency));
+    ++bins[bin];
+
+    if (count == 0 || latency < minimum)
+    {
+        minimum = latency;
+    }
+    if (count == 0 || latency > maximum)
+    {
+        maximum = latency;
+    }
+    total += latency;
+    ++count;
+}
+
+std::uint64_t LatencyHistogram::getCount() const
+{
+    return count;
+}
+
+double LatencyHistogram::getMean() const
+{
+    return (count > 0 ? total / static_cast<double>(count) : 0.0);
+}
+
+double LatencyHistogram::getMin() const
+{
+    return minimum;
+}
+
+double LatencyHistogram::getMax() const
+{
+    return maximum;
+}
+
+double LatencyHistogram::getPercentile(double p) const
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    // the first bin the cumulative count reaches p in
+    const double wanted = p * static_cast<double>(count);
+    std::uint64_t seen = 0;
+    for (std::size_t ms = 0; ms + 1 < bins.size(); ++ms)
+    {
+        seen += bins[ms];
+        if (static_cast<double>(seen) >= wanted)
+        {
+            // report the top of the bin, so it's an upper bound
+            const double top = static_cast<double>(ms + 1);
+            return (top < maximum ? top : maximum);
+        }
+    }
+
+    return maximum;
+}
+
+std::uint64_t LatencyHistogram::getBin(std::size_t ms) const
+{
+    return (ms < bins.size() ? bins[ms] : 0);
+}
+
+std::size_t LatencyHistogram::getBinCount() const
+{
+    return bins.size();
+}
+
+std::ostream &operator<<(std::ostream &str, const LatencyHistogram &h)
+{
+    const std::ios_base::fmtflags flags = str.flags();
+    const std::streamsize precision = str.precision();
+
+    str << std::fixed << std::setprecision(2)
+        << "n " << h.getCount()
+        << ", mean " << h.getMean()
+        << " ms, min " << h.getMin()
+        << " ms, median " << h.getPercentile(0.5)
+        << " ms, 95% " << h.getPercentile(0.95)
+        << " ms, max " << h.getMax() << " ms" << std::endl;
+
+    const std::size_t last = h.getBinCount() - 1;
+    for (std::size_t ms = 0; ms <= last; ++ms)
+    {
+        if (h.getBin(ms) == 0)
+        {
+            continue;
+        }
+
+        str << "  " << std::setw(4) << ms << (ms == last ? "+ ms: " : "  ms: ")
+            << h.getBin(ms) << std::endl;
+    }
+
+    str.flags(flags);
+    str.precision(precision);
+    return str;
+}
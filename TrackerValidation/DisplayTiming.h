@@ -0,0 +1,64 @@
+// Display timing: when targets actually appear on the screen.
+// A target is drawn some time after it is asked for (the redraw has to be
+// scheduled, drawn, and wait for the buffer swap). The UI timestamps each
+// target once the swap has completed, which is the best estimate of when the
+// subject could first see it, and keeps a histogram of the delay.
+
+#ifndef DISPLAYTIMING_H
+#define DISPLAYTIMING_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// When the target a measurement was made on appeared.
+struct TargetOnset
+{
+    // system clock time of the buffer swap which showed the target
+    std::chrono::time_point<std::chrono::system_clock> shown;
+
+    // time from the target appearing to the measurement (ms). Very short
+    // (or negative) times are anticipatory.
+    double reactionTime;
+};
+
+// Histogram of latencies in 1 ms bins.
+class LatencyHistogram
+{
+  private:
+    // one bin per ms, and the last for anything longer
+    std::vector<std::uint64_t> bins;
+
+    std::uint64_t count;
+    double total;
+    double minimum;
+    double maximum;
+
+  public:
+    // @param maxLatency latencies of this many ms or more share the last bin
+    explicit LatencyHistogram(std::size_t maxLatency = 100);
+
+    // add a latency, in ms
+    void add(double latency);
+
+    std::uint64_t getCount() const;
+    double getMean() const;
+    double getMin() const;
+    double getMax() const;
+
+    // Latency (ms) which fraction p of the latencies were under, to the
+    // nearest bin. The last bin is reported as the maximum.
+    // @returns 0 if there are no latencies
+    double getPercentile(double p) const;
+
+    // number of latencies in [ms, ms + 1)
+    std::uint64_t getBin(std::size_t ms) const;
+    std::size_t getBinCount() const;
+
+    // a one line summary, then a line for each non-empty bin
+    friend std::ostream &operator<<(std::ostream &str, const LatencyHistogram &h);
+};
+
+#endif // not defined DISPLAYTIMING_H
@@ -4,58 +4,132 @@
 #include "DummyTrackerCollector.h"
 
 #include <chrono>
+#include <iostream>
+#include <stdexcept>
 
 #ifdef _WIN32
     #include <Windows.h>
     #include <WinUser.h>
 #else
     #include <X11/Xlib.h>
+#endif
 
-    typedef struct POINT {
-        unsigned int x;
-        unsigned int y;
-    } POINT;
-    bool GetCursorPos(POINT *pt)
+namespace
+{
+    // Reads the mouse pointer position. On X11 this holds a single display
+    // connection for its lifetime rather than opening one for every read.
+    class CursorReader
     {
-        Window root, child;
-        int screenX, screenY, windowX, windowY;
-        unsigned int mask;
-        Display *disp = XOpenDisplay(nullptr);
-        if (XQueryPointer(disp, DefaultRootWindow(disp), &root, &child,
-            &screenX, &screenY, &windowX, &windowY, &mask))
+      private:
+#ifndef _WIN32
+        Display *disp;
+#endif
+
+      public:
+        CursorReader()
         {
-            pt->x = screenX;
-            pt->y = screenY;
+#ifndef _WIN32
+            disp = XOpenDisplay(nullptr);
+            if (disp == nullptr)
+            {
+                throw std::runtime_error("Could not open X display to read the mouse pointer");
+            }
+#endif
         }
-        else
+
+        ~CursorReader()
         {
-            // could not determine mouse pointer
-            pt->x = 0;
-            pt->y = 0;
+#ifndef _WIN32
+            XCloseDisplay(disp);
+#endif
         }
-        XCloseDisplay(disp);
-        
-        return true;
-    }
+
+        CursorReader(const CursorReader &) = delete;
+        CursorReader &operator=(const CursorReader &) = delete;
+
+        // read the pointer position
+        // @returns true if successful
+        bool read(unsigned int &x, unsigned int &y)
+        {
+#ifdef _WIN32
+            POINT pt;
+            if (!GetCursorPos(&pt))
+            {
+                return false;
+            }
+
+            x = pt.x;
+            y = pt.y;
+#else
+            Window root, child;
+            int screenX, screenY, windowX, windowY;
+            unsigned int mask;
+            if (!XQueryPointer(disp, DefaultRootWindow(disp), &root, &child,
+                &screenX, &screenY, &windowX, &windowY, &mask))
+            {
+                // pointer is on another screen
+                return false;
+            }
+
+            x = screenX;
+            y = screenY;
 #endif
+            return true;
+        }
+    };
+}
 
 DummyTrackerCollector::DummyTrackerCollector(ScreenPositionStore &store,
                                              const TrackerConfig &config)
     : ThreadTrackerCollector(store, config)
 { }
 
+unsigned int DummyTrackerCollector::getSampleRate() const
+{
+    if (config.sampleRate == 0)
+    {
+        return defaultSampleRate;
+    }
+
+    return (config.sampleRate > maxSampleRate ? maxSampleRate : config.sampleRate);
+}
+
 void DummyTrackerCollector::collectData()
 {
+    CursorReader cursor;
+
+    const unsigned int rate = getSampleRate();
+    if (rate != config.sampleRate && config.sampleRate != 0)
+    {
+        std::cerr << getName() << " tracker sample rate limited to " << rate
+                  << " Hz" << std::endl;
+    }
+
+    const std::chrono::nanoseconds period(1000000000ULL / rate);
+
+    // Sleep until absolute deadlines so the time spent reading the pointer
+    // doesn't slow the rate down. If we fall more than a whole period behind
+    // (e.g. the system was busy), start again from now rather than trying to
+    // catch up with a burst of samples.
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now();
+
     // keep looping until we are told to stop
     double sequence = 0;
     while (isRunning())
     {
-        POINT pt;
-        if (GetCursorPos(&pt))
+        unsigned int x, y;
+        if (cursor.read(x, y))
         {
-            unsigned int x = pt.x, y = pt.y;
             position.setCurrentPositionSingle(std::make_pair(x, y), ++sequence);
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
+
+        deadline += period;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (deadline + period < now)
+        {
+            deadline = now;
+        }
+
+        std::this_thread::sleep_until(deadline);
     }
 }
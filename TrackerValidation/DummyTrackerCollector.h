@@ -17,6 +17,10 @@ class DummyTrackerCollector
     void collectData();
 
   public:
+    // polling rate used if none is configured, and the fastest we will go
+    static const unsigned int defaultSampleRate = 10; // Hz
+    static const unsigned int maxSampleRate = 1000; // Hz
+
     DummyTrackerCollector(ScreenPositionStore &store,
                           const TrackerConfig &config);
 
@@ -25,6 +29,10 @@ class DummyTrackerCollector
         static const std::string name = "Mouse";
         return name;
     }
+
+    // The rate (Hz) the mouse will be polled at. This is the configured
+    // rate, limited to maxSampleRate.
+    unsigned int getSampleRate() const;
 };
 
 #endif // defined DUMMYTRACKERCOLLECTOR_H
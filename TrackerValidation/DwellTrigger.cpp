@@ -0,0 +1,139 @@
+// Gaze-contingent measurement trigger.
+
+#include "DwellTrigger.h"
+
+#include <stdexcept>
+
+namespace
+{
+    const std::uint64_t armedBit = 1;
+
+    // the state for the next generation
+    std::uint64_t nextState(std::uint64_t state, bool armed)
+    {
+        return (((state >> 1) + 1) << 1) | (armed ? armedBit : 0);
+    }
+}
+
+DwellTrigger::DwellTrigger(double dwellTime, double radius)
+    : radiusSq(radius * radius), state(0),
+      targetX(0), targetY(0), seenGeneration(0), dwelling(false),
+      pending(false), firedGeneration(0)
+{
+    if (dwellTime <= 0.0 || radius <= 0.0)
+    {
+        throw std::runtime_error("Invalid dwell settings");
+    }
+
+    this->dwellTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(dwellTime));
+}
+
+void DwellTrigger::arm(std::pair<unsigned int, unsigned int> target)
+{
+    targetX = target.first;
+    targetY = target.second;
+
+    // the collector may disarm at the same time, when it fires
+    std::uint64_t s = state;
+    while (!state.compare_exchange_weak(s, nextState(s, true)))
+    { }
+}
+
+void DwellTrigger::disarm()
+{
+    std::uint64_t s = state;
+    while (!state.compare_exchange_weak(s, nextState(s, false)))
+    { }
+}
+
+void DwellTrigger::onSample(const GazeSample &sample)
+{
+    const std::uint64_t s = state;
+    const std::uint64_t gen = s >> 1;
+    if (gen != seenGeneration)
+    {
+        seenGeneration = gen;
+        dwelling = false;
+    }
+
+    if ((s & armedBit) == 0)
+    {
+        dwelling = false;
+        return;
+    }
+
+    // average of the valid eyes
+    double x, y;
+    if (sample.rightValid && sample.leftValid)
+    {
+        x = (static_cast<double>(sample.right.first) + sample.left.first) / 2.0;
+        y = (static_cast<double>(sample.right.second) + sample.left.second) / 2.0;
+    }
+    else if (sample.rightValid)
+    {
+        x = sample.right.first;
+        y = sample.right.second;
+    }
+    else if (sample.leftValid)
+    {
+        x = sample.left.first;
+        y = sample.left.second;
+    }
+    else
+    {
+        // lost tracking (e.g. a blink) - start again
+        dwelling = false;
+        return;
+    }
+
+    const double dx = x - targetX;
+    const double dy = y - targetY;
+    if (dx * dx + dy * dy > radiusSq)
+    {
+        dwelling = false;
+        return;
+    }
+
+    if (!dwelling)
+    {
+        dwelling = true;
+        dwellStart = sample.sampleTime;
+    }
+
+    if (sample.sampleTime - dwellStart >= dwellTime)
+    {
+        dwelling = false;
+
+        // disarm, unless it has been re-armed (or disarmed) since we looked,
+        // in which case this firing is stale
+        std::uint64_t expected = s;
+        if (state.compare_exchange_strong(expected, s & ~armedBit))
+        {
+            std::lock_guard<std::mutex> lock(fireMutex);
+            firedSample = sample;
+            firedGeneration = gen;
+            pending = true;
+        }
+    }
+}
+
+bool DwellTrigger::poll(GazeSample &out)
+{
+    if (!pending)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(fireMutex);
+    pending = false;
+
+    // ignore it if we've been re-armed (or disarmed) since
+    if (firedGeneration != (state >> 1))
+    {
+        return false;
+    }
+
+    out = firedSample;
+    return true;
+}
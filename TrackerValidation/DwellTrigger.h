@@ -0,0 +1,68 @@
+// Gaze-contingent measurement trigger.
+// Fires once the gaze has stayed within a radius of the target for the
+// dwell time. It listens to the gaze store, so it is evaluated on the
+// tracker data collector's thread for every sample, and fires at the
+// sample it completes on rather than at the next UI tick. The UI thread
+// then polls for the firing and makes the measurement as of that sample.
+
+#ifndef DWELLTRIGGER_H
+#define DWELLTRIGGER_H
+
+#include "GazeSampleBuffer.h"
+#include "ScreenPositionStore.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <utility> // for std::pair
+
+class DwellTrigger : public GazeSampleListener
+{
+  private:
+    std::chrono::steady_clock::duration dwellTime;
+    double radiusSq;
+
+    // The generation, which changes with every arm/disarm so the collector
+    // thread knows to start the dwell again, shifted left one, with the
+    // lowest bit set when armed. Keeping both in one word means the
+    // collector can disarm after firing only if nothing has changed since,
+    // so a stale firing can't undo a newer arm().
+    std::atomic<std::uint64_t> state;
+    std::atomic<unsigned int> targetX;
+    std::atomic<unsigned int> targetY;
+
+    // only used on the collector thread
+    std::uint64_t seenGeneration;
+    bool dwelling;
+    std::chrono::steady_clock::time_point dwellStart;
+
+    // the sample which completed the dwell, and the generation it was for
+    std::mutex fireMutex;
+    std::atomic<bool> pending;
+    GazeSample firedSample;
+    std::uint64_t firedGeneration;
+
+  public:
+    // @param dwellTime ms the gaze must stay on target
+    // @param radius pixels from the target centre counted as on target
+    // @throws std::runtime_error if either is not positive
+    DwellTrigger(double dwellTime, double radius);
+
+    // Start watching for a dwell on the target at this position. Any
+    // earlier firing which hasn't been polled is dropped.
+    void arm(std::pair<unsigned int, unsigned int> target);
+
+    // Stop watching (e.g. a measurement was taken some other way).
+    void disarm();
+
+    // called for each gaze sample, on the collector thread
+    void onSample(const GazeSample &sample) override;
+
+    // Has the trigger fired since it was armed? It is disarmed when it
+    // fires, so this returns true once per arm().
+    // @param out the sample which completed the dwell
+    bool poll(GazeSample &out);
+};
+
+#endif // not defined DWELLTRIGGER_H
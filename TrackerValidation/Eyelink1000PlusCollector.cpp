@@ -4,12 +4,32 @@
 #include "Eyelink1000PlusCollector.h"
 
 #include "common.h"
+#include "DisplayGeometry.h"
+#include "TrackerClock.h"
 #include "eyelink/core_expt.h"
 #include "eyelink/eyelink.h"
 
 #include <cstring>
 #include <stdexcept>
 
+namespace
+{
+    // A float sample co-ordinate in screen pixels, or common::invalidCoord if
+    // there isn't a usable one. This is checked before converting, as
+    // negative floats (including MISSING_DATA) and NaNs can't be converted
+    // to unsigned.
+    unsigned int toPixel(bool valid, float value)
+    {
+        if (!valid || value == MISSING_DATA || !(value >= 0.0f)
+            || value >= static_cast<float>(common::invalidCoord))
+        {
+            return common::invalidCoord;
+        }
+
+        return static_cast<unsigned int>(value);
+    }
+}
+
 void Eyelink1000PlusCollector::collectData()
 {
     // connection mode
@@ -36,7 +56,7 @@ void Eyelink1000PlusCollector::collectData()
     }
 
     // set the screen resolution
-    std::pair<unsigned int, unsigned int> res = common::getScreenRes();
+    std::pair<unsigned int, unsigned int> res = DisplayGeometry::get().getResolution();
     eyecmd_printf("screen_pixel_coords = 0 0 %i %i", res.first, res.second);
 
     // eyecmd_printf can take up to 500ms to process
@@ -61,53 +81,55 @@ void Eyelink1000PlusCollector::collectData()
         throw std::runtime_error("No data available for tracker " + getName());
     }
 
-    ALL_DATA buf;
+    // Drain every item on the link queue rather than just looking at the
+    // newest sample, so no samples are skipped at 1000/2000 Hz. Events are
+    // not requested (see start_recording above) but are skipped if present.
+    ALLF_DATA buf;
     std::memset(&buf, 0, sizeof(buf));
 
-    if (DUMMY_MODE)
-    {
-        // if we're faking a connection, fake some valid data while we're at it
-        buf.is.flags = SAMPLE_LEFT + SAMPLE_RIGHT;
-        buf.is.gx[0] = 880;
-        buf.is.gx[1] = 882;
-        buf.is.gy[0] = 421;
-        buf.is.gy[1] = 420;
-    }
+    // sample times are in ms on the tracker clock
+    TrackerClock clock(1000.0);
 
     unsigned int xPos[2], yPos[2];
     while (isRunning())
     {
-        if (eyelink_newest_sample(&buf))
+        INT16 dataType = eyelink_get_next_data(nullptr);
+
+        if (dataType == 0)
+        {
+            // Queue is empty - wait for the next sample rather than spinning.
+            // The timeout is short so we notice when we're asked to stop.
+            eyelink_wait_for_data(10, 1, 0);
+            continue;
+        }
+
+        if (dataType != SAMPLE_TYPE || eyelink_get_float_data(&buf) != SAMPLE_TYPE)
+        {
+            continue;
+        }
+
+        // flags is a bitfield. Bitmask SAMPLE_LEFT for left data
+        // available, SAMPLE_RIGHT for right data available.
+        // Float samples are already in screen pixels (no prescaler).
+        for (int eye = LEFT_EYE; eye <= RIGHT_EYE; ++eye)
         {
-            // flags is a bitfield. Bitmask SAMPLE_LEFT for left data
-            // available, SAMPLE_RIGHT for right data available.
-            bool validData[2];
-            for (int eye = LEFT_EYE; eye <= RIGHT_EYE; ++eye)
-            {
-                int bitmask = (eye == LEFT_EYE ? SAMPLE_LEFT : SAMPLE_RIGHT);
-                validData[eye] = (buf.is.flags & bitmask) != 0;
-            
-                xPos[eye] = buf.is.gx[eye] / eyelink_position_prescaler();
-                yPos[eye] = buf.is.gy[eye] / eyelink_position_prescaler();
-
-                if (!validData[eye] || xPos[eye] == MISSING_DATA)
-                {
-                    xPos[eye] = common::invalidCoord;
-                }
-
-                if (!validData[eye] || yPos[eye] == MISSING_DATA)
-                {
-                    yPos[eye] = common::invalidCoord;
-                }
-            }
-
-            std::pair<unsigned int, unsigned int> gazePosRight
-                = std::make_pair(xPos[RIGHT_EYE], yPos[RIGHT_EYE]);
-            std::pair<unsigned int, unsigned int> gazePosLeft
-                = std::make_pair(xPos[LEFT_EYE], yPos[LEFT_EYE]);
-
-            position.setCurrentPositionRightLeft(gazePosRight, gazePosLeft, buf.is.time);
+            int bitmask = (eye == LEFT_EYE ? SAMPLE_LEFT : SAMPLE_RIGHT);
+            bool validData = (buf.fs.flags & bitmask) != 0;
+
+            xPos[eye] = toPixel(validData, buf.fs.gx[eye]);
+            yPos[eye] = toPixel(validData, buf.fs.gy[eye]);
         }
+
+        std::pair<unsigned int, unsigned int> gazePosRight
+            = std::make_pair(xPos[RIGHT_EYE], yPos[RIGHT_EYE]);
+        std::pair<unsigned int, unsigned int> gazePosLeft
+            = std::make_pair(xPos[LEFT_EYE], yPos[LEFT_EYE]);
+
+        // tracker time in ms, including the half ms offset at 2000 Hz
+        double trackerTime = FLOAT_TIME(&buf.fs);
+        position.setCurrentPositionRightLeft(
+            gazePosRight, gazePosLeft, trackerTime,
+            clock.update(trackerTime, std::chrono::steady_clock::now()));
     }
 
     stop_recording();
@@ -0,0 +1,435 @@
+// Streaming fixation detection.
+
+#include "FixationDetector.h"
+
+#include <algorithm> // for std::min, std::max
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    // I-VT: velocity is measured over at least this long
+    const std::chrono::milliseconds velocityInterval(20);
+
+    // a gap in the data longer than this ends any fixation
+    const std::chrono::milliseconds maxGap(100);
+
+    // average position of the valid eyes
+    // @returns false if neither eye is valid
+    bool position(const GazeSample &sample, double &x, double &y)
+    {
+        if (sample.rightValid && sample.leftValid)
+        {
+            x = (static_cast<double>(sample.right.first) + sample.left.first) / 2.0;
+            y = (static_cast<double>(sample.right.second) + sample.left.second) / 2.0;
+        }
+        else if (sample.rightValid)
+        {
+            x = sample.right.first;
+            y = sample.right.second;
+        }
+        else if (sample.leftValid)
+        {
+            x = sample.left.first;
+            y = sample.left.second;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    // add p to the back of a monotonic queue. The front of the queue is then
+    // the smallest (or largest) value in the window.
+    template <typename Compare>
+    void pushExtreme(std::deque<std::pair<double, std::uint64_t> > &queue,
+                     double value, std::uint64_t n, Compare keep)
+    {
+        while (!queue.empty() && !keep(queue.back().first, value))
+        {
+            queue.pop_back();
+        }
+        queue.emplace_back(value, n);
+    }
+}
+
+double Fixation::getDuration() const
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+FixationDetector::FixationDetector(Method method, double threshold,
+                                   double minDuration)
+    : method(method), threshold(threshold)
+{
+    if (threshold < 0.0 || minDuration < 0.0)
+    {
+        throw std::runtime_error("Invalid fixation detector settings");
+    }
+
+    if (this->threshold == 0.0)
+    {
+        this->threshold = (method == Method::Velocity
+                           ? defaultVelocityThreshold
+                           : defaultDispersionThreshold);
+    }
+
+    this->minDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(minDuration));
+
+    reset();
+}
+
+void FixationDetector::reset()
+{
+    haveLast = false;
+    pointCount = 0;
+    history.clear();
+    haveLastFixation = false;
+    fixationCount = 0;
+
+    // clear the candidate without keeping it
+    fixating = false;
+    finish();
+}
+
+void FixationDetector::extend(const Point &p)
+{
+    if (count == 0)
+    {
+        start = p.t;
+    }
+    ++count;
+    sumX += p.x;
+    sumY += p.y;
+    end = p.t;
+
+    if (!fixating && end - start >= minDuration)
+    {
+        fixating = true;
+    }
+}
+
+void FixationDetector::dropFront()
+{
+    const Point &p = window.front();
+    --count;
+    sumX -= p.x;
+    sumY -= p.y;
+
+    if (minX.front().second == p.n)
+    {
+        minX.pop_front();
+    }
+    if (maxX.front().second == p.n)
+    {
+        maxX.pop_front();
+    }
+    if (minY.front().second == p.n)
+    {
+        minY.pop_front();
+    }
+    if (maxY.front().second == p.n)
+    {
+        maxY.pop_front();
+    }
+
+    window.pop_front();
+    if (!window.empty())
+    {
+        start = window.front().t;
+    }
+}
+
+void FixationDetector::finish()
+{
+    if (fixating)
+    {
+        lastFixation = getCurrentFixation();
+        haveLastFixation = true;
+        ++fixationCount;
+    }
+
+    fixating = false;
+    count = 0;
+    sumX = 0.0;
+    sumY = 0.0;
+    window.clear();
+    minX.clear();
+    maxX.clear();
+    minY.clear();
+    maxY.clear();
+}
+
+GazeEventType FixationDetector::addSample(const GazeSample &sample)
+{
+    double x, y;
+    if (!position(sample, x, y))
+    {
+        finish();
+        history.clear();
+        return GazeEventType::Blink;
+    }
+
+    // lost data (or a clock reset) - start again
+    const std::chrono::steady_clock::time_point t = sample.sampleTime;
+    if (haveLast && (t < lastTime || t - lastTime > maxGap))
+    {
+        finish();
+        history.clear();
+    }
+    haveLast = true;
+    lastTime = t;
+
+    const Point p = { t, x, y, pointCount++ };
+    return (method == Method::Velocity ? addVelocity(p) : addDispersion(p));
+}
+
+GazeEventType FixationDetector::addVelocity(const Point &p)
+{
+    // measure from the newest sample at least velocityInterval old
+    history.push_back(p);
+    while (history.size() > 2 && p.t - history[1].t >= velocityInterval)
+    {
+        history.pop_front();
+    }
+
+    const Point &ref = history.front();
+    const double dt = std::chrono::duration<double>(p.t - ref.t).count();
+    const double velocity = (dt > 0.0 ? std::hypot(p.x - ref.x, p.y - ref.y) / dt : 0.0);
+
+    if (velocity > threshold)
+    {
+        finish();
+        return GazeEventType::Saccade;
+    }
+
+    extend(p);
+    return GazeEventType::Fixation;
+}
+
+GazeEventType FixationDetector::addDispersion(const Point &p)
+{
+    if (fixating)
+    {
+        // only the bounds are needed once we're in a fixation
+        const double dispersion
+            = (std::max(boundMaxX, p.x) - std::min(boundMinX, p.x))
+            + (std::max(boundMaxY, p.y) - std::min(boundMinY, p.y));
+        if (dispersion <= threshold)
+        {
+            boundMinX = std::min(boundMinX, p.x);
+            boundMaxX = std::max(boundMaxX, p.x);
+            boundMinY = std::min(boundMinY, p.y);
+            boundMaxY = std::max(boundMaxY, p.y);
+            extend(p);
+            return GazeEventType::Fixation;
+        }
+
+        // this sample starts a new candidate
+        finish();
+    }
+
+    window.push_back(p);
+    pushExtreme(minX, p.x, p.n, [](double a, double b) { return a < b; });
+    pushExtreme(maxX, p.x, p.n, [](double a, double b) { return a > b; });
+    pushExtreme(minY, p.y, p.n, [](double a, double b) { return a < b; });
+    pushExtreme(maxY, p.y, p.n, [](double a, double b) { return a > b; });
+    extend(p);
+
+    // slide the start of the window forward until it fits again
+    while ((maxX.front().first - minX.front().first)
+         + (maxY.front().first - minY.front().first) > threshold)
+    {
+        dropFront();
+    }
+
+    // the window may have become long enough before it was trimmed, so
+    // check again
+    fixating = (end - start >= minDuration);
+    if (fixating)
+    {
+        boundMinX = minX.front().first;
+        boundMaxX = maxX.front().first;
+        boundMinY = minY.front().first;
+        boundMaxY = maxY.front().first;
+        window.clear();
+        minX.clear();
+        maxX.clear();
+        minY.clear();
+        maxY.clear();
+    }
+
+    return (count > 1 ? GazeEventType::Fixation : GazeEventType::Saccade);
+}
+
+bool FixationDetector::inFixation() const
+{
+    return fixating;
+}
+
+Fixation FixationDetector::getCurrentFixation() const
+{
+    Fixation f;
+    f.x = (count > 0 ? sumX / count : 0.0);
+    f.y = (count > 0 ? sumY / count : 0.0);
+    f.start = start;
+    f.end = end;
+    f.count = count;
+    return f;
+}
+
+bool FixationDetector::getLastFixation(Fixation &out) const
+{
+    if (haveLastFixation)
+    {
+        out = lastFixation;
+    }
+    return haveLastFixation;
+}
+
+std::uint64_t FixationDetector::getFixationCount() const
+{
+    return fixationCount;
+}
+
+FixationDetector::Method FixationDetector::getMethod() const
+{
+    return method;
+}
+
+double FixationDetector::getThreshold() const
+{
+    return threshold;
+}
+
+FixationDetector::Method FixationDetector::methodFromName(const std::string &name)
+{
+    if (name == "ivt")
+    {
+        return Method::Velocity;
+    }
+    else if (name == "idt")
+    {
+        return Method::Dispersion;
+    }
+
+    throw std::runtime_error("Unknown fixation method: " + name);
+}
+
+FixationTracker::FixationTracker(const ScreenPositionStore &store,
+                                 const FixationDetector &detector)
+    : store(store), detector(detector), next(0), running(false)
+{ }
+
+FixationTracker::~FixationTracker()
+{
+    stop();
+}
+
+void FixationTracker::start()
+{
+    if (running)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(detectorMutex);
+        detector.reset();
+        fixations.clear();
+        next = store.getSampleBuffer().pushed();
+    }
+
+    running = true;
+    trackThread = std::thread(&FixationTracker::track, this);
+}
+
+void FixationTracker::stop()
+{
+    if (!running)
+    {
+        return;
+    }
+
+    running = false;
+    trackThread.join();
+}
+
+void FixationTracker::catchUp()
+{
+    const GazeSampleBuffer &buffer = store.getSampleBuffer();
+    const std::uint64_t head = buffer.pushed();
+
+    if (head - next > buffer.capacity())
+    {
+        // fallen too far behind to know what happened in between
+        detector.reset();
+        next = head - buffer.capacity();
+    }
+
+    GazeSample sample;
+    for (; next < head; ++next)
+    {
+        if (!buffer.get(next, sample))
+        {
+            continue;
+        }
+
+        const std::uint64_t before = detector.getFixationCount();
+        detector.addSample(sample);
+
+        // keep any fixation that just finished
+        Fixation f;
+        if (detector.getFixationCount() != before && detector.getLastFixation(f))
+        {
+            fixations.push_back(f);
+            if (fixations.size() > historySize)
+            {
+                fixations.pop_front();
+            }
+        }
+    }
+}
+
+void FixationTracker::track()
+{
+    while (running)
+    {
+        {
+            std::lock_guard<std::mutex> lock(detectorMutex);
+            catchUp();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+bool FixationTracker::getFixation(std::chrono::steady_clock::time_point since,
+                                  Fixation &out)
+{
+    std::lock_guard<std::mutex> lock(detectorMutex);
+    catchUp();
+
+    if (detector.inFixation())
+    {
+        Fixation f = detector.getCurrentFixation();
+        if (f.start >= since)
+        {
+            out = f;
+            return true;
+        }
+    }
+
+    for (auto it = fixations.rbegin(); it != fixations.rend(); ++it)
+    {
+        if (it->start >= since)
+        {
+            out = *it;
+            return true;
+        }
+    }
+
+    return false;
+}
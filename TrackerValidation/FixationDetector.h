@@ -0,0 +1,198 @@
+// Streaming fixation detection.
+// Each gaze sample is classified as it arrives as part of a fixation, a
+// saccade, or a blink (no valid data), using either a velocity threshold
+// (I-VT) or a dispersion threshold (I-DT). The centroid and duration of the
+// current fixation are kept up to date, so the fixation a subject made on a
+// target can be used directly instead of post-processing full rate logs.
+//
+// Thresholds are in screen pixels, as that is what the trackers give us.
+
+#ifndef FIXATIONDETECTOR_H
+#define FIXATIONDETECTOR_H
+
+#include "GazeSampleBuffer.h"
+#include "ScreenPositionStore.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility> // for std::pair
+
+enum class GazeEventType { Fixation, Saccade, Blink };
+
+struct Fixation
+{
+    // centroid, in pixels
+    double x;
+    double y;
+
+    // sample times of the first and last samples
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+
+    // number of samples
+    std::size_t count;
+
+    // @returns end - start, in ms
+    double getDuration() const;
+};
+
+class FixationDetector
+{
+  public:
+    enum class Method { Velocity, Dispersion };
+
+    // defaults used if a threshold of zero is given
+    static constexpr double defaultVelocityThreshold = 1000.0; // pixels/s
+    static constexpr double defaultDispersionThreshold = 50.0; // pixels
+
+    // shortest fixation which will be reported (ms)
+    static constexpr double defaultMinDuration = 100.0;
+
+  private:
+    struct Point
+    {
+        std::chrono::steady_clock::time_point t;
+        double x;
+        double y;
+        std::uint64_t n; // position in the stream, to match up min/max entries
+    };
+
+    Method method;
+    double threshold;
+    std::chrono::steady_clock::duration minDuration;
+
+    // newest sample time, and how many valid samples we've had
+    bool haveLast;
+    std::chrono::steady_clock::time_point lastTime;
+    std::uint64_t pointCount;
+
+    // I-VT: recent samples, enough to measure the velocity over a short
+    // interval rather than from sample to sample (which is mostly noise at
+    // high sample rates)
+    std::deque<Point> history;
+
+    // I-DT: samples in the candidate fixation, with monotonic queues of the
+    // extremes of each axis so the dispersion can be found as samples are
+    // dropped from the front. These are only used until the candidate is
+    // long enough to be a fixation; after that only the bounds are kept.
+    std::deque<Point> window;
+    std::deque<std::pair<double, std::uint64_t> > minX, maxX, minY, maxY;
+    double boundMinX, boundMaxX, boundMinY, boundMaxY;
+
+    // the candidate fixation. It becomes a fixation once it lasts for at
+    // least minDuration.
+    std::size_t count;
+    double sumX;
+    double sumY;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+    bool fixating;
+
+    // most recent complete fixation
+    bool haveLastFixation;
+    Fixation lastFixation;
+    std::uint64_t fixationCount;
+
+    GazeEventType addVelocity(const Point &p);
+    GazeEventType addDispersion(const Point &p);
+
+    // add/remove a point from the candidate
+    void extend(const Point &p);
+    void dropFront();
+
+    // end the candidate, keeping it if it was a fixation
+    void finish();
+
+  public:
+    // @param threshold pixels/s for Velocity, or pixels (x range + y range)
+    //        for Dispersion. Zero uses the default for the method.
+    // @param minDuration shortest fixation reported, in ms
+    // @throws std::runtime_error if the threshold or duration are negative
+    explicit FixationDetector(Method method = Method::Velocity,
+                              double threshold = 0.0,
+                              double minDuration = defaultMinDuration);
+
+    // Classify the next sample. Samples must be given in order. A sample
+    // with no valid eye is a blink, and ends any fixation. The sample is
+    // classed as a fixation if it meets the threshold, even if the
+    // fixation is not yet long enough to be reported.
+    GazeEventType addSample(const GazeSample &sample);
+
+    // Is the subject currently fixating (for at least the minimum duration)?
+    bool inFixation() const;
+
+    // The current fixation. Only meaningful if inFixation() is true.
+    Fixation getCurrentFixation() const;
+
+    // The most recent complete fixation.
+    // @returns false if there hasn't been one
+    bool getLastFixation(Fixation &out) const;
+
+    // Number of fixations completed.
+    std::uint64_t getFixationCount() const;
+
+    Method getMethod() const;
+    double getThreshold() const;
+
+    // Forget everything.
+    void reset();
+
+    // Parse a method name ("ivt" or "idt").
+    // @throws std::runtime_error if the name is not known
+    static Method methodFromName(const std::string &name);
+};
+
+// Runs a FixationDetector over every sample a ScreenPositionStore receives,
+// on a background thread (in the same way as GazeRecorder), and keeps the
+// last few fixations so the one belonging to a target can be found.
+class FixationTracker
+{
+  public:
+    // number of complete fixations kept
+    static constexpr std::size_t historySize = 16;
+
+  private:
+    const ScreenPositionStore &store;
+
+    // protects everything below
+    mutable std::mutex detectorMutex;
+    FixationDetector detector;
+    std::deque<Fixation> fixations;
+    std::uint64_t next;
+
+    std::thread trackThread;
+    std::atomic<bool> running;
+
+    // process any samples we haven't seen yet. detectorMutex must be held.
+    void catchUp();
+
+    void track();
+
+  public:
+    FixationTracker(const ScreenPositionStore &store,
+                    const FixationDetector &detector);
+    ~FixationTracker();
+
+    FixationTracker(const FixationTracker &) = delete;
+    FixationTracker &operator=(const FixationTracker &) = delete;
+
+    // Start following samples received from now on. If it is already
+    // running, this will do nothing.
+    void start();
+
+    // If it is not running, this will do nothing.
+    void stop();
+
+    // Find the newest fixation which started at or after since, including
+    // the current one, after processing every sample received so far.
+    // @returns false if there isn't one
+    bool getFixation(std::chrono::steady_clock::time_point since, Fixation &out);
+};
+
+#endif // not defined FIXATIONDETECTOR_H
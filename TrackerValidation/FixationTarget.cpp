@@ -5,13 +5,57 @@
 
 #include "CircleTarget.h"
 #include "CrosshairBullseyeTarget.h"
+#include "DisplayGeometry.h"
 
+#include <GL/freeglut.h>
 #include <stdexcept>
 
 FixationTarget::FixationTarget(unsigned int diameter)
     :diameter(diameter)
 { }
 
+// The display lists aren't deleted here, as their windows' contexts may not
+// be current (or may be gone). They are freed with the contexts.
+FixationTarget::~FixationTarget()
+{ }
+
+void FixationTarget::drawOpenGL(unsigned int x, unsigned int y)
+{
+    // build the target for this window if we haven't already
+    const int window = glutGetWindow();
+    std::map<int, unsigned int>::iterator list = displayLists.find(window);
+    if (list == displayLists.end())
+    {
+        GLuint id = glGenLists(1);
+        if (id != 0)
+        {
+            glNewList(id, GL_COMPILE);
+            buildOpenGL();
+            glEndList();
+        }
+        list = displayLists.insert(std::make_pair(window, id)).first;
+    }
+
+    // move it into place, and convert from pixels to OpenGL positions
+    const PixelTransform transform = DisplayGeometry::get().getPixelTransform();
+    const std::pair<double, double> centre = transform.toPosition(x, y);
+
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glTranslated(centre.first, centre.second, 0.0);
+    glScaled(transform.getXScale(), -transform.getYScale(), 1.0);
+    if (list->second != 0)
+    {
+        glCallList(list->second);
+    }
+    else
+    {
+        // couldn't make a display list - draw it directly
+        buildOpenGL();
+    }
+    glPopMatrix();
+}
+
 unsigned int FixationTarget::getDiameter(void) const
 {
     return diameter;
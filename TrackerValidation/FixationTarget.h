@@ -4,6 +4,7 @@
 #ifndef FIXATIONTARGET_H
 #define FIXATIONTARGET_H
 
+#include <map>
 #include <string>
 
 class FixationTarget
@@ -12,13 +13,27 @@ class FixationTarget
     // Diameter of the target, in pixels.
     unsigned int diameter;
 
+    // OpenGL display list holding the target, for each window it has been
+    // drawn in (each window has its own context).
+    std::map<int, unsigned int> displayLists;
+
   protected:
     // constructor - hidden as this is using a factory pattern
     FixationTarget(unsigned int diameter);
 
+    // Draw the target with OpenGL, centred on (0, 0), in pixels (y down the
+    // screen). This is compiled into a display list the first time the
+    // target is drawn, so is only called once per window.
+    virtual void buildOpenGL() = 0;
+
   public:
+    virtual ~FixationTarget();
+
+    FixationTarget(const FixationTarget &) = delete;
+    FixationTarget &operator=(const FixationTarget &) = delete;
+
     // draw target with OpenGL at pixel location (x, y)
-    virtual void drawOpenGL(unsigned int x, unsigned int y) = 0;
+    void drawOpenGL(unsigned int x, unsigned int y);
 
     // create a target of the given type.
     // @throws std::runtime_error if type does not match a known type.
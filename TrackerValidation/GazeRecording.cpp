@@ -0,0 +1,477 @@
+// Recording and playback of raw gaze sample streams.
+
+#include "GazeRecording.h"
+
+#include "common.h"
+
+#include <cstring> // for std::memcpy
+#include <istream>
+#include <stdexcept>
+
+namespace
+{
+    const char magic1[8] = { 'G', 'A', 'Z', 'E', 'R', 'E', 'C', '1' };
+    const char magic2[8] = { 'G', 'A', 'Z', 'E', 'R', 'E', 'C', '2' };
+
+    // version 1 records are a fixed size
+    const std::size_t recordSize1 = 33;
+
+    // longest version 2 record: flags, 7 varints and the target index
+    const std::size_t maxRecordSize2 = 1 + 7 * 10 + 5;
+
+    const unsigned char FLAG_RIGHT_VALID = 0x1;
+    const unsigned char FLAG_LEFT_VALID = 0x2;
+
+    // version 2 only
+    const unsigned char FLAG_RIGHT_POSITION = 0x4;   // right x, y follow
+    const unsigned char FLAG_LEFT_POSITION = 0x8;    // left x, y follow
+    const unsigned char FLAG_TARGET_VISIBLE = 0x10;
+    const unsigned char FLAG_TARGET_CHANGED = 0x20;  // target index follows
+
+    // Values are stored little-endian regardless of the host, so recordings
+    // can be moved between machines.
+    void put64(unsigned char *&p, std::uint64_t v)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            *p++ = static_cast<unsigned char>(v >> (8 * i));
+        }
+    }
+
+    void putVarint(unsigned char *&p, std::uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            *p++ = static_cast<unsigned char>(v | 0x80);
+            v >>= 7;
+        }
+        *p++ = static_cast<unsigned char>(v);
+    }
+
+    // zigzag encoding, so small negative numbers are small too
+    void putSignedVarint(unsigned char *&p, std::int64_t v)
+    {
+        putVarint(p, (static_cast<std::uint64_t>(v) << 1)
+                     ^ static_cast<std::uint64_t>(v >> 63));
+    }
+
+    std::uint64_t get64(const unsigned char *&p)
+    {
+        std::uint64_t v = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            v |= static_cast<std::uint64_t>(*p++) << (8 * i);
+        }
+        return v;
+    }
+
+    std::uint32_t get32(const unsigned char *&p)
+    {
+        std::uint32_t v = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            v |= static_cast<std::uint32_t>(*p++) << (8 * i);
+        }
+        return v;
+    }
+
+    // @returns false at the end of the file, or if the varint is corrupt
+    bool readVarint(std::istream &in, std::uint64_t &v)
+    {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            const int c = in.get();
+            if (c == std::char_traits<char>::eof())
+            {
+                return false;
+            }
+            v |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+            if ((c & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool readSignedVarint(std::istream &in, std::int64_t &v)
+    {
+        std::uint64_t u;
+        if (!readVarint(in, u))
+        {
+            return false;
+        }
+        v = static_cast<std::int64_t>(u >> 1) ^ -static_cast<std::int64_t>(u & 1);
+        return true;
+    }
+
+    // has the eye got a position to store? Lost eyes are (invalidCoord,
+    // invalidCoord), which aren't worth storing.
+    bool hasPosition(std::pair<unsigned int, unsigned int> pos)
+    {
+        return pos.first != common::invalidCoord || pos.second != common::invalidCoord;
+    }
+
+    std::int64_t change(unsigned int from, unsigned int to)
+    {
+        return static_cast<std::int64_t>(to) - static_cast<std::int64_t>(from);
+    }
+
+    unsigned int apply(unsigned int from, std::int64_t change)
+    {
+        return static_cast<unsigned int>(static_cast<std::int64_t>(from) + change);
+    }
+}
+
+GazeRecordingWriter::GazeRecordingWriter(const std::string &path)
+    : file(path, std::ios::binary | std::ios::trunc), count(0),
+      lastIdentifier(0), lastArrival(0), lastRight(0, 0), lastLeft(0, 0),
+      lastTarget(0)
+{
+    if (!file)
+    {
+        throw std::runtime_error("Could not open gaze recording file " + path);
+    }
+
+    file.write(magic2, sizeof(magic2));
+}
+
+void GazeRecordingWriter::write(const GazeSample &sample, const GazeTargetState &target)
+{
+    unsigned char record[8 + maxRecordSize2]; // start time, and the sample
+    unsigned char *p = record;
+
+    if (count == 0)
+    {
+        // tie the recording to the system clock, to line it up with the
+        // measurements
+        start = sample.arrival;
+        const std::chrono::system_clock::time_point startTime
+            = std::chrono::system_clock::now()
+              - std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                  std::chrono::steady_clock::now() - start);
+        put64(p, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                startTime.time_since_epoch()).count()));
+    }
+
+    std::uint64_t identifier;
+    std::memcpy(&identifier, &sample.identifier, sizeof(identifier));
+    const std::int64_t arrival = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        sample.arrival - start).count();
+    const std::int64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        sample.sampleTime - sample.arrival).count();
+
+    unsigned char flags = (sample.rightValid ? FLAG_RIGHT_VALID : 0)
+                          | (sample.leftValid ? FLAG_LEFT_VALID : 0)
+                          | (hasPosition(sample.right) ? FLAG_RIGHT_POSITION : 0)
+                          | (hasPosition(sample.left) ? FLAG_LEFT_POSITION : 0)
+                          | (target.visible ? FLAG_TARGET_VISIBLE : 0);
+    if (count == 0 || target.index != lastTarget)
+    {
+        flags |= FLAG_TARGET_CHANGED;
+    }
+
+    *p++ = flags;
+    // successive identifiers (usually times) share their top bits
+    putVarint(p, identifier ^ lastIdentifier);
+    putSignedVarint(p, arrival - lastArrival);
+    putSignedVarint(p, latency);
+    if (flags & FLAG_RIGHT_POSITION)
+    {
+        putSignedVarint(p, change(lastRight.first, sample.right.first));
+        putSignedVarint(p, change(lastRight.second, sample.right.second));
+        lastRight = sample.right;
+    }
+    if (flags & FLAG_LEFT_POSITION)
+    {
+        putSignedVarint(p, change(lastLeft.first, sample.left.first));
+        putSignedVarint(p, change(lastLeft.second, sample.left.second));
+        lastLeft = sample.left;
+    }
+    if (flags & FLAG_TARGET_CHANGED)
+    {
+        putVarint(p, target.index);
+        lastTarget = target.index;
+    }
+
+    lastIdentifier = identifier;
+    lastArrival = arrival;
+
+    file.write(reinterpret_cast<const char *>(record), p - record);
+    ++count;
+}
+
+void GazeRecordingWriter::flush()
+{
+    file.flush();
+}
+
+std::uint64_t GazeRecordingWriter::getCount() const
+{
+    return count;
+}
+
+GazeRecordingReader::GazeRecordingReader(const std::string &path)
+    : file(path, std::ios::binary), count(0), version(0),
+      lastIdentifier(0), lastArrival(0), lastRight(0, 0), lastLeft(0, 0),
+      lastTarget()
+{
+    if (!file)
+    {
+        throw std::runtime_error("Could not open gaze recording file " + path);
+    }
+
+    char header[sizeof(magic2)];
+    if (file.read(header, sizeof(header)))
+    {
+        if (std::memcmp(header, magic1, sizeof(magic1)) == 0)
+        {
+            version = 1;
+        }
+        else if (std::memcmp(header, magic2, sizeof(magic2)) == 0)
+        {
+            version = 2;
+        }
+    }
+
+    if (version == 0)
+    {
+        throw std::runtime_error(path + " is not a gaze recording");
+    }
+}
+
+bool GazeRecordingReader::next(GazeSample &out, GazeTargetState *target)
+{
+    if (!(version == 1 ? readVersion1(out) : readVersion2(out)))
+    {
+        // end of file, or a partial record at the end of an interrupted
+        // recording
+        return false;
+    }
+
+    out.sequence = count++;
+    if (target != nullptr)
+    {
+        *target = lastTarget;
+    }
+
+    return true;
+}
+
+bool GazeRecordingReader::readVersion1(GazeSample &out)
+{
+    unsigned char record[recordSize1];
+    if (!file.read(reinterpret_cast<char *>(record), sizeof(record)))
+    {
+        return false;
+    }
+
+    const unsigned char *p = record;
+    std::uint64_t identifier = get64(p);
+    std::memcpy(&out.identifier, &identifier, sizeof(identifier));
+    out.arrival = std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(static_cast<std::int64_t>(get64(p)))));
+    out.sampleTime = out.arrival;
+    out.right.first = get32(p);
+    out.right.second = get32(p);
+    out.left.first = get32(p);
+    out.left.second = get32(p);
+    out.rightValid = (*p & FLAG_RIGHT_VALID) != 0;
+    out.leftValid = (*p & FLAG_LEFT_VALID) != 0;
+
+    return true;
+}
+
+bool GazeRecordingReader::readVersion2(GazeSample &out)
+{
+    if (count == 0)
+    {
+        unsigned char buffer[8];
+        if (!file.read(reinterpret_cast<char *>(buffer), sizeof(buffer)))
+        {
+            return false;
+        }
+        const unsigned char *p = buffer;
+        startTime = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(static_cast<std::int64_t>(get64(p)))));
+    }
+
+    const int flags = file.get();
+    std::uint64_t identifier, index = lastTarget.index;
+    std::int64_t arrival, latency;
+    std::int64_t rightX = 0, rightY = 0, leftX = 0, leftY = 0;
+    if (flags == std::char_traits<char>::eof()
+        || !readVarint(file, identifier)
+        || !readSignedVarint(file, arrival)
+        || !readSignedVarint(file, latency)
+        || ((flags & FLAG_RIGHT_POSITION)
+            && (!readSignedVarint(file, rightX) || !readSignedVarint(file, rightY)))
+        || ((flags & FLAG_LEFT_POSITION)
+            && (!readSignedVarint(file, leftX) || !readSignedVarint(file, leftY)))
+        || ((flags & FLAG_TARGET_CHANGED) && !readVarint(file, index)))
+    {
+        return false;
+    }
+
+    lastIdentifier ^= identifier;
+    lastArrival += arrival;
+    if (flags & FLAG_RIGHT_POSITION)
+    {
+        lastRight = std::make_pair(apply(lastRight.first, rightX),
+                                   apply(lastRight.second, rightY));
+    }
+    if (flags & FLAG_LEFT_POSITION)
+    {
+        lastLeft = std::make_pair(apply(lastLeft.first, leftX),
+                                  apply(lastLeft.second, leftY));
+    }
+    lastTarget.index = static_cast<unsigned int>(index);
+    lastTarget.visible = (flags & FLAG_TARGET_VISIBLE) != 0;
+
+    std::memcpy(&out.identifier, &lastIdentifier, sizeof(lastIdentifier));
+    out.arrival = std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(lastArrival)));
+    out.sampleTime = out.arrival
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(latency));
+    const std::pair<unsigned int, unsigned int> missing(common::invalidCoord,
+                                                        common::invalidCoord);
+    out.right = (flags & FLAG_RIGHT_POSITION) ? lastRight : missing;
+    out.left = (flags & FLAG_LEFT_POSITION) ? lastLeft : missing;
+    out.rightValid = (flags & FLAG_RIGHT_VALID) != 0;
+    out.leftValid = (flags & FLAG_LEFT_VALID) != 0;
+
+    return true;
+}
+
+int GazeRecordingReader::getVersion() const
+{
+    return version;
+}
+
+std::chrono::system_clock::time_point GazeRecordingReader::getStartTime() const
+{
+    return startTime;
+}
+
+GazeRecorder::GazeRecorder(const ScreenPositionStore &store,
+                           const std::string &path)
+    : store(store), writer(path), running(false), lost(0)
+{ }
+
+GazeRecorder::~GazeRecorder()
+{
+    stop();
+}
+
+void GazeRecorder::start()
+{
+    if (running)
+    {
+        return;
+    }
+
+    // only record what arrives from now on
+    {
+        std::lock_guard<std::mutex> lock(targetMutex);
+        targetChanges.clear();
+    }
+    running = true;
+    recordThread = std::thread(&GazeRecorder::record, this,
+                               store.getSampleBuffer().pushed());
+}
+
+void GazeRecorder::stop()
+{
+    if (!running)
+    {
+        return;
+    }
+
+    running = false;
+    recordThread.join();
+    writer.flush();
+}
+
+void GazeRecorder::record(std::uint64_t next)
+{
+    const GazeSampleBuffer &buffer = store.getSampleBuffer();
+
+    GazeSample sample;
+    GazeTargetState target = GazeTargetState();
+    std::vector<std::pair<std::uint64_t, GazeTargetState> > changes;
+    std::size_t nextChange = 0;
+    bool keepGoing = true;
+    while (keepGoing)
+    {
+        // check before draining, so the last pass picks up everything
+        // received before we were stopped
+        keepGoing = running;
+
+        const std::uint64_t head = buffer.pushed();
+
+        // pick up target changes up to here. Anything set after head was
+        // read applies to later samples.
+        {
+            std::lock_guard<std::mutex> lock(targetMutex);
+            changes.erase(changes.begin(), changes.begin() + nextChange);
+            changes.insert(changes.end(), targetChanges.begin(), targetChanges.end());
+            targetChanges.clear();
+        }
+        nextChange = 0;
+
+        if (head - next > buffer.capacity())
+        {
+            // fallen too far behind - these have been overwritten
+            lost += head - next - buffer.capacity();
+            next = head - buffer.capacity();
+        }
+
+        for (; next < head; ++next)
+        {
+            while (nextChange < changes.size() && changes[nextChange].first <= next)
+            {
+                target = changes[nextChange++].second;
+            }
+
+            if (buffer.get(next, sample))
+            {
+                writer.write(sample, target);
+            }
+            else
+            {
+                ++lost;
+            }
+        }
+
+        if (keepGoing)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+}
+
+void GazeRecorder::setTarget(unsigned int index, bool visible)
+{
+    GazeTargetState state;
+    state.index = index;
+    state.visible = visible;
+
+    std::lock_guard<std::mutex> lock(targetMutex);
+    targetChanges.push_back(std::make_pair(store.getSampleBuffer().pushed(), state));
+}
+
+std::uint64_t GazeRecorder::getRecordedCount() const
+{
+    return writer.getCount();
+}
+
+std::uint64_t GazeRecorder::getLostCount() const
+{
+    return lost;
+}
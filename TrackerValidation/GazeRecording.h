@@ -0,0 +1,167 @@
+// Recording and playback of raw gaze sample streams.
+// Every sample a tracker data collector produces can be written to a compact
+// binary file, and read back later (see ReplayTrackerCollector) so a session
+// can be rerun on exactly the same input, or reanalysed with different
+// settings.
+//
+// File format (all values little-endian):
+//   header:  8 byte magic "GAZEREC2"
+//   then, before the first sample:
+//     int64    system clock time of the first sample, in ns since the epoch
+//   samples, each encoded against the one before (starting from zero):
+//     uint8    flags (see FLAG_* in GazeRecording.cpp)
+//     varint   identifier bits XOR the previous identifier's bits
+//     svarint  arrival time change, in ns
+//     svarint  sample (tracker) time minus arrival time, in ns
+//     svarint  right x, right y change (if the right eye has a position)
+//     svarint  left x, left y change (if the left eye has a position)
+//     varint   target index (if it has changed)
+//   varints are LEB128, and svarints are zigzag encoded varints. A sample at
+//   150 Hz usually takes 10-20 bytes.
+//
+// Version 1 recordings ("GAZEREC1", 33 byte fixed size samples with no
+// sample time or target) can still be read.
+
+#ifndef GAZERECORDING_H
+#define GAZERECORDING_H
+
+#include "GazeSampleBuffer.h"
+#include "ScreenPositionStore.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <utility> // for std::pair
+#include <vector>
+
+// What the subject was being shown when a sample arrived.
+struct GazeTargetState
+{
+    unsigned int index; // target index (see Validator::getTargetIndex)
+    bool visible;       // was the target on the screen?
+};
+
+class GazeRecordingWriter
+{
+  private:
+    std::ofstream file;
+
+    // arrival time of the first sample, which the others are relative to
+    std::chrono::steady_clock::time_point start;
+    std::uint64_t count;
+
+    // the previous sample, which the next one is encoded against
+    std::uint64_t lastIdentifier;
+    std::int64_t lastArrival;
+    std::pair<unsigned int, unsigned int> lastRight;
+    std::pair<unsigned int, unsigned int> lastLeft;
+    unsigned int lastTarget;
+
+  public:
+    // @throws std::runtime_error if the file couldn't be opened
+    explicit GazeRecordingWriter(const std::string &path);
+
+    void write(const GazeSample &sample,
+               const GazeTargetState &target = GazeTargetState());
+
+    // write out anything buffered
+    void flush();
+
+    // number of samples written
+    std::uint64_t getCount() const;
+};
+
+class GazeRecordingReader
+{
+  private:
+    std::ifstream file;
+    std::uint64_t count;
+    int version;
+
+    // system clock time of the first sample
+    std::chrono::system_clock::time_point startTime;
+
+    // the previous sample, which the next one is decoded against
+    std::uint64_t lastIdentifier;
+    std::int64_t lastArrival;
+    std::pair<unsigned int, unsigned int> lastRight;
+    std::pair<unsigned int, unsigned int> lastLeft;
+    GazeTargetState lastTarget;
+
+    bool readVersion1(GazeSample &out);
+    bool readVersion2(GazeSample &out);
+
+  public:
+    // @throws std::runtime_error if the file couldn't be opened or is not a
+    //         gaze recording
+    explicit GazeRecordingReader(const std::string &path);
+
+    // Read the next sample. The arrival and sample times are relative to the
+    // first sample's arrival (i.e. arrival.time_since_epoch() is the
+    // offset), and the sequence is the sample's position in the file.
+    // @param target if not nullptr, set to what was being shown
+    // @returns false at the end of the file
+    bool next(GazeSample &out, GazeTargetState *target = nullptr);
+
+    // 1 or 2
+    int getVersion() const;
+
+    // System clock time the first sample arrived. This is the epoch for
+    // version 1 recordings, and until the first sample has been read.
+    std::chrono::system_clock::time_point getStartTime() const;
+};
+
+// Follows the sample history of a ScreenPositionStore on a background thread
+// and writes every new sample to a recording. The history holds a couple of
+// seconds of data, so the writer has plenty of time to keep up; any samples
+// which are overwritten before they could be written are counted as lost.
+// Memory use is fixed by the history size, and the caller never waits for
+// the file.
+class GazeRecorder
+{
+  private:
+    const ScreenPositionStore &store;
+    GazeRecordingWriter writer;
+
+    std::thread recordThread;
+    std::atomic<bool> running;
+    std::atomic<std::uint64_t> lost;
+
+    // target changes not yet reached by the writer, as (first sample
+    // number, state), oldest first
+    std::mutex targetMutex;
+    std::vector<std::pair<std::uint64_t, GazeTargetState> > targetChanges;
+
+    // write samples from number next onwards until stopped
+    void record(std::uint64_t next);
+
+  public:
+    // @throws std::runtime_error if the file couldn't be opened
+    GazeRecorder(const ScreenPositionStore &store, const std::string &path);
+    ~GazeRecorder();
+
+    GazeRecorder(const GazeRecorder &) = delete;
+    GazeRecorder &operator=(const GazeRecorder &) = delete;
+
+    // Start recording samples received from now on. If it is already
+    // running, this will do nothing.
+    void start();
+
+    // Write out everything received so far and stop. If it is not running,
+    // this will do nothing.
+    void stop();
+
+    // Set what's being shown, for samples received from now on.
+    void setTarget(unsigned int index, bool visible);
+
+    // Number of samples written, and lost. The recorded count is only
+    // accurate once stopped.
+    std::uint64_t getRecordedCount() const;
+    std::uint64_t getLostCount() const;
+};
+
+#endif // not defined GAZERECORDING_H
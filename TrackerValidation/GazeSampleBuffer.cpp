@@ -0,0 +1,195 @@
+// Lock-free ring buffer of timestamped gaze samples.
+
+#include "GazeSampleBuffer.h"
+
+#include <algorithm> // for std::reverse
+#include <cstring> // for std::memcpy
+
+namespace
+{
+    // word layout of a packed sample
+    enum SlotWord
+    {
+        WORD_RIGHT = 0,     // x | y << 32
+        WORD_LEFT,          // x | y << 32
+        WORD_IDENTIFIER,    // bit pattern of the double
+        WORD_ARRIVAL,       // steady_clock ticks
+        WORD_SAMPLE_TIME,   // steady_clock ticks
+        WORD_FLAGS          // validity bits
+    };
+
+    constexpr std::uint64_t FLAG_RIGHT_VALID = 0x1;
+    constexpr std::uint64_t FLAG_LEFT_VALID = 0x2;
+
+    std::uint64_t packPos(std::pair<unsigned int, unsigned int> pos)
+    {
+        return static_cast<std::uint64_t>(pos.first)
+               | (static_cast<std::uint64_t>(pos.second) << 32);
+    }
+
+    std::pair<unsigned int, unsigned int> unpackPos(std::uint64_t word)
+    {
+        return std::make_pair(static_cast<unsigned int>(word & 0xffffffffu),
+                              static_cast<unsigned int>(word >> 32));
+    }
+
+    std::size_t roundUpPow2(std::size_t n)
+    {
+        std::size_t p = 1;
+        while (p < n)
+        {
+            p <<= 1;
+        }
+        return p;
+    }
+}
+
+GazeSampleBuffer::GazeSampleBuffer(std::size_t capacity)
+    : slotCount(roundUpPow2(capacity < 2 ? 2 : capacity)),
+      mask(0), head(0)
+{
+    mask = slotCount - 1;
+    slots.reset(new Slot[slotCount]);
+    for (std::size_t i = 0; i < slotCount; ++i)
+    {
+        slots[i].seq.store(0, std::memory_order_relaxed);
+        for (auto &w : slots[i].words)
+        {
+            w.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void GazeSampleBuffer::push(const GazeSample &sample)
+{
+    std::uint64_t words[slotWords];
+    words[WORD_RIGHT] = packPos(sample.right);
+    words[WORD_LEFT] = packPos(sample.left);
+    std::memcpy(&words[WORD_IDENTIFIER], &sample.identifier, sizeof(double));
+    words[WORD_ARRIVAL] = static_cast<std::uint64_t>(
+        sample.arrival.time_since_epoch().count());
+    words[WORD_SAMPLE_TIME] = static_cast<std::uint64_t>(
+        sample.sampleTime.time_since_epoch().count());
+    words[WORD_FLAGS] = (sample.rightValid ? FLAG_RIGHT_VALID : 0)
+                        | (sample.leftValid ? FLAG_LEFT_VALID : 0);
+
+    // only this thread writes head, so a relaxed load is fine
+    const std::uint64_t n = head.load(std::memory_order_relaxed);
+    Slot &slot = slots[n & mask];
+
+    // mark the slot as being written before touching the data
+    slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (std::size_t i = 0; i < slotWords; ++i)
+    {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+    head.store(n + 1, std::memory_order_release);
+}
+
+bool GazeSampleBuffer::readSlot(std::uint64_t n, GazeSample &out) const
+{
+    const Slot &slot = slots[n & mask];
+
+    const std::uint64_t before = slot.seq.load(std::memory_order_acquire);
+    if (before != 2 * n + 2)
+    {
+        // being written, or already reused for a newer sample
+        return false;
+    }
+
+    std::uint64_t words[slotWords];
+    for (std::size_t i = 0; i < slotWords; ++i)
+    {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != before)
+    {
+        // the producer lapped us mid-read
+        return false;
+    }
+
+    out.right = unpackPos(words[WORD_RIGHT]);
+    out.left = unpackPos(words[WORD_LEFT]);
+    std::memcpy(&out.identifier, &words[WORD_IDENTIFIER], sizeof(double));
+    out.arrival = std::chrono::steady_clock::time_point(
+        std::chrono::steady_clock::duration(
+            static_cast<std::chrono::steady_clock::rep>(words[WORD_ARRIVAL])));
+    out.sampleTime = std::chrono::steady_clock::time_point(
+        std::chrono::steady_clock::duration(
+            static_cast<std::chrono::steady_clock::rep>(words[WORD_SAMPLE_TIME])));
+    out.rightValid = (words[WORD_FLAGS] & FLAG_RIGHT_VALID) != 0;
+    out.leftValid = (words[WORD_FLAGS] & FLAG_LEFT_VALID) != 0;
+    out.sequence = n;
+
+    return true;
+}
+
+bool GazeSampleBuffer::latest(GazeSample &out) const
+{
+    // The newest slot can only fail to read if the producer has lapped the
+    // whole buffer while we were reading, so just try again with the new head.
+    for (;;)
+    {
+        const std::uint64_t h = head.load(std::memory_order_acquire);
+        if (h == 0)
+        {
+            return false;
+        }
+
+        if (readSlot(h - 1, out))
+        {
+            return true;
+        }
+    }
+}
+
+std::size_t GazeSampleBuffer::snapshot(
+    std::chrono::steady_clock::time_point from,
+    std::chrono::steady_clock::time_point to,
+    std::vector<GazeSample> &out) const
+{
+    out.clear();
+
+    const std::uint64_t h = head.load(std::memory_order_acquire);
+    const std::uint64_t oldest = (h > slotCount ? h - slotCount : 0);
+
+    // walk backwards from the newest sample, stopping once we are before the
+    // start of the range or hit a slot which has since been overwritten.
+    GazeSample sample;
+    for (std::uint64_t n = h; n > oldest; --n)
+    {
+        if (!readSlot(n - 1, sample) || sample.arrival < from)
+        {
+            break;
+        }
+
+        if (sample.arrival <= to)
+        {
+            out.push_back(sample);
+        }
+    }
+
+    std::reverse(out.begin(), out.end());
+    return out.size();
+}
+
+bool GazeSampleBuffer::get(std::uint64_t n, GazeSample &out) const
+{
+    return readSlot(n, out);
+}
+
+std::uint64_t GazeSampleBuffer::pushed() const
+{
+    return head.load(std::memory_order_acquire);
+}
+
+std::size_t GazeSampleBuffer::capacity() const
+{
+    return slotCount;
+}
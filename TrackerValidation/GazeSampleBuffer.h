@@ -0,0 +1,113 @@
+// Lock-free ring buffer of timestamped gaze samples.
+// One thread (the tracker data collector) pushes samples at the full tracker
+// rate. Any number of threads can read the newest sample, or take a snapshot
+// of a time range, without ever blocking the producer. Each slot is guarded
+// by a sequence number (a "seqlock"); readers retry or give up if the slot
+// was overwritten while they were reading it.
+
+#ifndef GAZESAMPLEBUFFER_H
+#define GAZESAMPLEBUFFER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility> // for std::pair
+#include <vector>
+
+// A single gaze sample, as received from the tracker.
+struct GazeSample
+{
+    // (x, y) screen co-ordinates, in pixels. If the tracker did not give a
+    // valid reading, the co-ordinates will be common::invalidCoord.
+    std::pair<unsigned int, unsigned int> right;
+    std::pair<unsigned int, unsigned int> left;
+
+    // Do we have valid readings for each eye?
+    bool rightValid;
+    bool leftValid;
+
+    // Tracker supplied identifier (sequence number, time, etc.), or zero if
+    // the tracker does not give one.
+    double identifier;
+
+    // When the sample was pushed into the buffer.
+    std::chrono::steady_clock::time_point arrival;
+
+    // When the tracker took the sample, on the host clock (see TrackerClock).
+    // For trackers which don't give a timestamp this is the arrival time.
+    std::chrono::steady_clock::time_point sampleTime;
+
+    // Position of this sample in the stream (0 = first sample pushed). This
+    // is set by the buffer; any value given to push() is ignored.
+    std::uint64_t sequence;
+};
+
+class GazeSampleBuffer
+{
+  public:
+    // 2 seconds of data at 2 kHz
+    static constexpr std::size_t defaultCapacity = 4096;
+
+  private:
+    // number of 64-bit words used to store a packed GazeSample
+    static constexpr std::size_t slotWords = 6;
+
+    // Each slot stores its sample packed into atomic words so that a reader
+    // racing with the producer is well defined. seq is 2n+1 while sample n
+    // is being written and 2n+2 once it is complete.
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint64_t> seq;
+        std::atomic<std::uint64_t> words[slotWords];
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t slotCount; // always a power of two
+    std::size_t mask;
+
+    // total number of samples pushed so far. Kept away from the slots so
+    // readers polling the head don't share a cache line with the data.
+    alignas(64) std::atomic<std::uint64_t> head;
+
+    // read sample number n into out.
+    // @returns false if the slot no longer (or does not yet) hold sample n.
+    bool readSlot(std::uint64_t n, GazeSample &out) const;
+
+  public:
+    // capacity is rounded up to the next power of two
+    explicit GazeSampleBuffer(std::size_t capacity = defaultCapacity);
+
+    GazeSampleBuffer(const GazeSampleBuffer &) = delete;
+    GazeSampleBuffer &operator=(const GazeSampleBuffer &) = delete;
+
+    // Add a sample to the buffer, overwriting the oldest if full.
+    // Only one thread may call this (single producer).
+    void push(const GazeSample &sample);
+
+    // Retrieve the newest sample.
+    // @returns false if no samples have been pushed yet.
+    bool latest(GazeSample &out) const;
+
+    // Copy all samples which arrived in the range [from, to] into out, oldest
+    // first. out is cleared first; its capacity is reused.
+    // @returns the number of samples copied.
+    std::size_t snapshot(std::chrono::steady_clock::time_point from,
+                         std::chrono::steady_clock::time_point to,
+                         std::vector<GazeSample> &out) const;
+
+    // Retrieve sample number n (0 = first sample pushed). Use pushed() to
+    // find the next sample to read, so every sample can be followed in order.
+    // @returns false if sample n has not been pushed yet, or has already
+    //          been overwritten.
+    bool get(std::uint64_t n, GazeSample &out) const;
+
+    // Total number of samples pushed since construction.
+    std::uint64_t pushed() const;
+
+    // Maximum number of samples held.
+    std::size_t capacity() const;
+};
+
+#endif // not defined GAZESAMPLEBUFFER_H
@@ -0,0 +1,108 @@
+// Summary statistics of the gaze samples in a time window.
+
+#include "GazeWindowStats.h"
+
+#include <algorithm> // for std::nth_element
+#include <cmath>
+
+namespace
+{
+    // median of values (which will be reordered)
+    double median(std::vector<double> &values)
+    {
+        const std::size_t mid = values.size() / 2;
+        std::nth_element(values.begin(), values.begin() + mid, values.end());
+        double m = values[mid];
+
+        if (values.size() % 2 == 0)
+        {
+            // the other middle value is the largest of the lower half
+            m = (m + *std::max_element(values.begin(), values.begin() + mid)) / 2.0;
+        }
+
+        return m;
+    }
+
+    void meanSD(const std::vector<double> &values, double &mean, double &sd)
+    {
+        double sum = 0.0;
+        for (double v : values)
+        {
+            sum += v;
+        }
+        mean = sum / values.size();
+
+        // two pass, as the values are large compared to their spread
+        double sumSq = 0.0;
+        for (double v : values)
+        {
+            sumSq += (v - mean) * (v - mean);
+        }
+        sd = (values.size() > 1 ? std::sqrt(sumSq / (values.size() - 1)) : 0.0);
+    }
+}
+
+void GazeWindowAggregator::aggregateEye(bool right, EyeWindowStats &out)
+{
+    xs.clear();
+    ys.clear();
+    for (const GazeSample &s : samples)
+    {
+        if (right ? s.rightValid : s.leftValid)
+        {
+            const std::pair<unsigned int, unsigned int> &pos = (right ? s.right : s.left);
+            xs.push_back(pos.first);
+            ys.push_back(pos.second);
+        }
+    }
+
+    out = EyeWindowStats{ xs.size(), 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    if (xs.empty())
+    {
+        return;
+    }
+
+    // sample to sample precision, while the values are still in order
+    double sumSq = 0.0;
+    for (std::size_t i = 1; i < xs.size(); ++i)
+    {
+        sumSq += (xs[i] - xs[i-1]) * (xs[i] - xs[i-1])
+               + (ys[i] - ys[i-1]) * (ys[i] - ys[i-1]);
+    }
+    out.rmsS2S = (xs.size() > 1 ? std::sqrt(sumSq / (xs.size() - 1)) : 0.0);
+
+    meanSD(xs, out.meanX, out.sdX);
+    meanSD(ys, out.meanY, out.sdY);
+    out.medianX = ::median(xs);
+    out.medianY = ::median(ys);
+}
+
+GazeWindowStats GazeWindowAggregator::aggregate(
+    const ScreenPositionStore &store,
+    std::chrono::steady_clock::time_point from,
+    std::chrono::steady_clock::time_point to)
+{
+    // A sample can't arrive before it was taken, so everything we want is
+    // in this arrival range. Drop the ones taken before the window.
+    store.getSamples(from, to, samples);
+    samples.erase(std::remove_if(samples.begin(), samples.end(),
+                                 [from](const GazeSample &s) {
+                                     return s.sampleTime < from;
+                                 }),
+                  samples.end());
+
+    GazeWindowStats stats;
+    aggregateEye(true, stats.right);
+    aggregateEye(false, stats.left);
+    return stats;
+}
+
+GazeWindowStats GazeWindowAggregator::aggregate(const std::vector<GazeSample> &window)
+{
+    samples.assign(window.begin(), window.end());
+
+    GazeWindowStats stats;
+    aggregateEye(true, stats.right);
+    aggregateEye(false, stats.left);
+    return stats;
+}
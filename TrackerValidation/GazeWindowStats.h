@@ -0,0 +1,59 @@
+// Summary statistics of the gaze samples in a time window, e.g. the few
+// hundred ms before a measurement was taken. This is much less noisy than
+// using a single sample, and doesn't depend on when the tracker last sent
+// data.
+
+#ifndef GAZEWINDOWSTATS_H
+#define GAZEWINDOWSTATS_H
+
+#include "GazeSampleBuffer.h"
+#include "ScreenPositionStore.h"
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+// Statistics for one eye. Positions are in pixels, and only valid samples
+// are used. If count is zero the other values are meaningless.
+struct EyeWindowStats
+{
+    std::size_t count;
+    double meanX, meanY;
+    double medianX, medianY;
+    double sdX, sdY;
+
+    // root mean square of the distance between successive samples (zero if
+    // there is only one sample)
+    double rmsS2S;
+};
+
+struct GazeWindowStats
+{
+    EyeWindowStats right;
+    EyeWindowStats left;
+};
+
+// Calculates GazeWindowStats from a ScreenPositionStore. The working buffers
+// are kept between calls, so once warmed up no memory is allocated and the
+// work is a single pass plus a partial sort per axis. This is quick enough
+// to run in a UI callback even with a few seconds of 2 kHz data.
+class GazeWindowAggregator
+{
+  private:
+    std::vector<GazeSample> samples;
+    std::vector<double> xs, ys;
+
+    void aggregateEye(bool right, EyeWindowStats &out);
+
+  public:
+    // Aggregate the samples taken (by sampleTime) in the range [from, to].
+    // Samples which arrived after to are not included.
+    GazeWindowStats aggregate(const ScreenPositionStore &store,
+                              std::chrono::steady_clock::time_point from,
+                              std::chrono::steady_clock::time_point to);
+
+    // Aggregate samples which have already been collected.
+    GazeWindowStats aggregate(const std::vector<GazeSample> &window);
+};
+
+#endif // not defined GAZEWINDOWSTATS_H
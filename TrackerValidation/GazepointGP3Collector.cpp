@@ -4,13 +4,19 @@
 #include "GazepointGP3Collector.h"
 
 #include "common.h"
+#include "DisplayGeometry.h"
+
+#include "GazepointRecordParser.h"
+#include "TrackerClock.h"
 
 #include "gazepoint/GPClient.h"
+#include <chrono>
 #include <iostream>
-#include <regex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 
 namespace
 {
@@ -52,11 +58,58 @@ void GazepointGP3Collector::collectData()
     // note: if BPOGV == 1 means the measurement is valid, 0 means invalid
     //       and the BPOG[X|Y] values are the last known values.
 
+    // screen config
+    std::pair<unsigned int, unsigned int> screenRes = DisplayGeometry::get().getResolution();
+
+    // Every record is parsed in place as soon as it is received, on the
+    // client's receive thread. This means we see every sample (not just the
+    // latest) and nothing is copied or allocated per record.
+    // <REC CNT="151747" LPOGX="0.87396" LPOGY="0.02765" LPOGV="1" RPOGX="0.89497" RPOGY="0.77830" RPOGV="1" />
+    static const unsigned int requiredFields
+        = GazepointRecordParser::FIELD_CNT
+        | GazepointRecordParser::FIELD_LPOGX | GazepointRecordParser::FIELD_LPOGY
+        | GazepointRecordParser::FIELD_LPOGV | GazepointRecordParser::FIELD_RPOGX
+        | GazepointRecordParser::FIELD_RPOGY | GazepointRecordParser::FIELD_RPOGV;
+
+    GazepointRecordParser parser;
+
+    // TIME is in seconds on the tracker clock. It's not required, so older
+    // servers which don't send it will still work (without sample times).
+    TrackerClock clock(1.0);
+
     GPClient client(config.ipAddress, config.ipPort);
+    client.set_rx_handler([&](std::string_view rxstr) {
+        GazepointRecord rec;
+        if (parser.parse(rxstr, rec, requiredFields)
+            != GazepointRecordParser::RESULT_OK)
+        {
+            // ACKs etc. are ignored, and malformed records are counted by
+            // the parser. Either way there's nothing else to do.
+            return;
+        }
+
+        // x,y values are a fraction of the screen size. These are sometimes
+        // <0 or >1, which is not mentioned in the docs, so calculatePos()
+        // treats those values as invalid.
+        std::pair<unsigned int, unsigned int> gazeRight
+            = ::calculatePos(rec.rpogv, rec.rpogx, rec.rpogy, screenRes);
+        std::pair<unsigned int, unsigned int> gazeLeft
+            = ::calculatePos(rec.lpogv, rec.lpogx, rec.lpogy, screenRes);
+
+        std::chrono::steady_clock::time_point arrival = std::chrono::steady_clock::now();
+        if (rec.fields & GazepointRecordParser::FIELD_TIME)
+        {
+            position.setCurrentPositionRightLeft(gazeRight, gazeLeft, rec.cnt,
+                                                 clock.update(rec.time, arrival));
+        }
+        else
+        {
+            position.setCurrentPositionRightLeft(gazeRight, gazeLeft, rec.cnt,
+                                                 arrival);
+        }
+    });
     client.client_connect();
 
-    // screen config
-    std::pair<unsigned int, unsigned int> screenRes = common::getScreenRes();
     std::stringstream screenConfig;
     screenConfig << "<SET ID=\"SCREEN_SIZE\" X=\"0\" Y=\"0\" WIDTH=\""
                  << screenRes.first << "\" HEIGHT=\""
@@ -64,53 +117,28 @@ void GazepointGP3Collector::collectData()
 
     client.send_cmd(screenConfig.str());
     client.send_cmd("<SET ID=\"ENABLE_SEND_COUNTER\" STATE=\"1\" />");
+    client.send_cmd("<SET ID=\"ENABLE_SEND_TIME\" STATE=\"1\" />");
     client.send_cmd("<SET ID=\"ENABLE_SEND_POG_RIGHT\" STATE=\"1\" />");
     client.send_cmd("<SET ID=\"ENABLE_SEND_POG_LEFT\" STATE=\"1\" />");
     client.send_cmd("<SET ID=\"ENABLE_SEND_DATA\" STATE=\"1\" />");
 
     while (isRunning())
     {
-        try
-        {
-            std::string rxstr = client.get_rx_latest();
-
-            // For efficiency sake, we assume the returned data is in the
-            // correct format. This means we can avoid the overhead of an XML
-            // parser and just pull out the data with regex :-)
-            // <REC CNT="151747" LPOGX="0.87396" LPOGY="0.02765" LPOGV="1" RPOGX="0.89497" RPOGY="0.77830" RPOGV="1" />
-            static const std::regex r(
-                "^<REC CNT=\"(\\d+)\" LPOGX=\"([01]\\.\\d+)\" LPOGY=\"([01]\\.\\d+)\" LPOGV=\"([01])\" RPOGX=\"([01]\\.\\d+)\" RPOGY=\"([01]\\.\\d+)\" RPOGV=\"([01])\" />$");
-            std::smatch matches;
-
-            // regex_match throws a read access violation when the main
-            // thread finishes but this is still running. This is caught below
-            // and ignored - if we're exiting then there's nothing to recover
-            if (std::regex_match(rxstr, matches, r))
-            {
-                // x,y values are a fraction of the screen size. These are
-                // sometimes <0 or >1, which is not mentioned in the docs,
-                // so we have ignored those values. The regex above will only
-                // match values [0,2), so we will exclude (1,2) below.
-                double id = std::stod(matches[1]);
-                double xLeft = std::stod(matches[2]);
-                double yLeft = std::stod(matches[3]);
-                bool validLeft = (std::string(matches[4])[0] == '1' ? true : false);
-                double xRight = std::stod(matches[5]);
-                double yRight = std::stod(matches[6]);
-                bool validRight = (std::string(matches[7])[0] == '1' ? true : false);
-
-                std::pair<unsigned int, unsigned int> gazeRight
-                    = ::calculatePos(validRight, xRight, yRight, screenRes);
-                std::pair<unsigned int, unsigned int> gazeLeft
-                    = ::calculatePos(validLeft, xLeft, yLeft, screenRes);
-
-                position.setCurrentPositionRightLeft(gazeRight, gazeLeft, id);
-            }
-        }
-        catch (std::exception &e)
-        {
-            // don't crash on exceptions, just try again
-            std::cerr << "Error: " << e.what() << std::endl;
-        }
+        // records are handled on the client's receive thread (see above),
+        // so all we need to do here is wait to be told to stop.
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
+
+    client.client_disconnect();
+
+    GPLatencyStats latency = client.get_dispatch_latency();
+    std::cout << getName() << " receive latency (wakeup to dispatch): "
+              << "mean " << latency.mean_us << "us, "
+              << "max " << latency.max_us << "us over "
+              << latency.count << " wakeups" << std::endl
+              << getName() << " records: " << parser.getParsedCount()
+              << " parsed, " << parser.getErrorCount() << " parse errors"
+              << std::endl
+              << getName() << " clock drift: " << clock.getDriftPpm()
+              << " ppm over " << clock.getSpan() << "s" << std::endl;
 }
@@ -0,0 +1,203 @@
+// Parser for Open Gaze API (Gazepoint) data records.
+
+#include "GazepointRecordParser.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    bool isNameChar(char c)
+    {
+        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')
+               || (c >= '0' && c <= '9') || c == '_';
+    }
+
+    // Look up which field an attribute name refers to.
+    // @returns 0 if we don't care about this attribute
+    unsigned int fieldFor(std::string_view name)
+    {
+        // check the length first to avoid comparing most names at all
+        switch (name.size())
+        {
+          case 3:
+            return (name == "CNT" ? GazepointRecordParser::FIELD_CNT : 0);
+          case 4:
+            return (name == "TIME" ? GazepointRecordParser::FIELD_TIME : 0);
+          case 5:
+            if (name[1] != 'P' || name[2] != 'O' || name[3] != 'G')
+            {
+                return 0;
+            }
+
+            {
+                unsigned int shift = 0;
+                switch (name[0])
+                {
+                  case 'L': shift = 2; break;
+                  case 'R': shift = 5; break;
+                  case 'B': shift = 8; break;
+                  default: return 0;
+                }
+
+                switch (name[4])
+                {
+                  case 'X': return 1u << shift;
+                  case 'Y': return 1u << (shift + 1);
+                  case 'V': return 1u << (shift + 2);
+                  default: return 0;
+                }
+            }
+          default:
+            return 0;
+        }
+    }
+
+    // parse a number, which must use the whole value
+    bool toDouble(const char *first, const char *last, double &out)
+    {
+        // from_chars doesn't accept a leading '+'
+        if (first != last && *first == '+')
+        {
+            ++first;
+        }
+
+        std::from_chars_result res = std::from_chars(first, last, out);
+        return res.ec == std::errc() && res.ptr == last && first != last;
+    }
+}
+
+GazepointRecordParser::GazepointRecordParser()
+    : parsed(0), ignored(0), errors(0)
+{}
+
+GazepointRecordParser::Result GazepointRecordParser::parse(
+    std::string_view text, GazepointRecord &rec, unsigned int required)
+{
+    static constexpr std::string_view tag = "<REC";
+
+    std::memset(&rec, 0, sizeof(rec));
+
+    const char *p = text.data();
+    const char *end = p + text.size();
+
+    while (p != end && isSpace(*p))
+    {
+        ++p;
+    }
+
+    if (static_cast<size_t>(end - p) < tag.size()
+        || std::memcmp(p, tag.data(), tag.size()) != 0
+        || (static_cast<size_t>(end - p) > tag.size() && isNameChar(p[tag.size()])))
+    {
+        ++ignored;
+        return RESULT_NOT_RECORD;
+    }
+    p += tag.size();
+
+    for (;;)
+    {
+        while (p != end && isSpace(*p))
+        {
+            ++p;
+        }
+
+        if (p == end)
+        {
+            // ran out of data before the closing "/>"
+            break;
+        }
+
+        if (*p == '/')
+        {
+            if (end - p < 2 || p[1] != '>'
+                || (rec.fields & required) != required)
+            {
+                break;
+            }
+
+            ++parsed;
+            return RESULT_OK;
+        }
+
+        // attribute name
+        const char *nameStart = p;
+        while (p != end && isNameChar(*p))
+        {
+            ++p;
+        }
+
+        if (p == nameStart || p == end || *p != '=')
+        {
+            break;
+        }
+        std::string_view name(nameStart, static_cast<size_t>(p - nameStart));
+        ++p;
+
+        // quoted value - find the closing quote with memchr, which the
+        // standard library vectorises for us
+        if (p == end || *p != '"')
+        {
+            break;
+        }
+        ++p;
+
+        const char *valueEnd = static_cast<const char *>(
+            std::memchr(p, '"', static_cast<size_t>(end - p)));
+        if (valueEnd == nullptr)
+        {
+            break;
+        }
+
+        unsigned int field = ::fieldFor(name);
+        if (field != 0)
+        {
+            double value;
+            if (!::toDouble(p, valueEnd, value))
+            {
+                break;
+            }
+
+            switch (field)
+            {
+              case FIELD_CNT:   rec.cnt = value; break;
+              case FIELD_TIME:  rec.time = value; break;
+              case FIELD_LPOGX: rec.lpogx = value; break;
+              case FIELD_LPOGY: rec.lpogy = value; break;
+              case FIELD_LPOGV: rec.lpogv = (value != 0.0); break;
+              case FIELD_RPOGX: rec.rpogx = value; break;
+              case FIELD_RPOGY: rec.rpogy = value; break;
+              case FIELD_RPOGV: rec.rpogv = (value != 0.0); break;
+              case FIELD_BPOGX: rec.bpogx = value; break;
+              case FIELD_BPOGY: rec.bpogy = value; break;
+              case FIELD_BPOGV: rec.bpogv = (value != 0.0); break;
+            }
+            rec.fields |= field;
+        }
+
+        p = valueEnd + 1;
+    }
+
+    ++errors;
+    return RESULT_ERROR;
+}
+
+unsigned long long GazepointRecordParser::getParsedCount() const
+{
+    return parsed;
+}
+
+unsigned long long GazepointRecordParser::getIgnoredCount() const
+{
+    return ignored;
+}
+
+unsigned long long GazepointRecordParser::getErrorCount() const
+{
+    return errors;
+}
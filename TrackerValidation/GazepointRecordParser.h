@@ -0,0 +1,79 @@
+// Parser for Open Gaze API (Gazepoint) data records, e.g.
+// <REC CNT="151747" LPOGX="0.87396" LPOGY="0.02765" LPOGV="1" RPOGX="0.89497" RPOGY="0.77830" RPOGV="1" />
+// This scans the attributes directly rather than using an XML parser or regex.
+// Attributes can be in any order, and unknown attributes are skipped. No
+// memory is allocated while parsing.
+
+#ifndef GAZEPOINTRECORDPARSER_H
+#define GAZEPOINTRECORDPARSER_H
+
+#include <string_view>
+
+// Values from a single <REC /> record. Only the fields flagged in "fields"
+// were present in the record; the others are zero.
+struct GazepointRecord
+{
+    unsigned int fields;
+
+    double cnt;     // CNT: sequence counter
+    double time;    // TIME: seconds since tracker start
+
+    double lpogx;   // left eye point of gaze (fraction of screen)
+    double lpogy;
+    bool lpogv;     // left eye data valid
+
+    double rpogx;   // right eye point of gaze (fraction of screen)
+    double rpogy;
+    bool rpogv;     // right eye data valid
+
+    double bpogx;   // best point of gaze (fraction of screen)
+    double bpogy;
+    bool bpogv;
+};
+
+class GazepointRecordParser
+{
+  private:
+    unsigned long long parsed;
+    unsigned long long ignored;
+    unsigned long long errors;
+
+  public:
+    // bits for GazepointRecord::fields
+    enum Field
+    {
+        FIELD_CNT   = 1 << 0,
+        FIELD_TIME  = 1 << 1,
+        FIELD_LPOGX = 1 << 2,
+        FIELD_LPOGY = 1 << 3,
+        FIELD_LPOGV = 1 << 4,
+        FIELD_RPOGX = 1 << 5,
+        FIELD_RPOGY = 1 << 6,
+        FIELD_RPOGV = 1 << 7,
+        FIELD_BPOGX = 1 << 8,
+        FIELD_BPOGY = 1 << 9,
+        FIELD_BPOGV = 1 << 10
+    };
+
+    enum Result
+    {
+        RESULT_OK,          // record parsed into rec
+        RESULT_NOT_RECORD,  // not a <REC /> (e.g. an <ACK />) - ignored
+        RESULT_ERROR        // looked like a <REC /> but was malformed
+    };
+
+    GazepointRecordParser();
+
+    // Parse a single record (without the "\r\n" delimiter).
+    // @param required bitmask of Field values which must be present, or the
+    //                 record is treated as malformed
+    Result parse(std::string_view text, GazepointRecord &rec,
+                 unsigned int required = 0);
+
+    // -- counters -- //
+    unsigned long long getParsedCount() const;
+    unsigned long long getIgnoredCount() const;
+    unsigned long long getErrorCount() const;
+};
+
+#endif // not defined GAZEPOINTRECORDPARSER_H
@@ -0,0 +1,308 @@
+// Append-only file writer which persists data as it goes.
+
+#include "IncrementalFileWriter.h"
+
+#include <cerrno>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    // thin wrappers so the rest of the code is the same on every platform
+#ifdef _WIN32
+    int openFile(const std::string &path, bool append)
+    {
+        int fd = -1;
+        _sopen_s(&fd, path.c_str(),
+                 _O_BINARY | (append ? (_O_WRONLY | _O_APPEND | _O_CREAT) : _O_RDWR),
+                 _SH_DENYNO, _S_IREAD | _S_IWRITE);
+        return fd;
+    }
+
+    long long writeFile(int fd, const char *data, std::size_t size)
+    {
+        return _write(fd, data, static_cast<unsigned int>(size));
+    }
+
+    long long readAt(int fd, char *data, std::size_t size, long long offset)
+    {
+        if (_lseeki64(fd, offset, SEEK_SET) < 0)
+        {
+            return -1;
+        }
+        return _read(fd, data, static_cast<unsigned int>(size));
+    }
+
+    long long fileSize(int fd)
+    {
+        return _lseeki64(fd, 0, SEEK_END);
+    }
+
+    bool syncFile(int fd)
+    {
+        return _commit(fd) == 0;
+    }
+
+    void closeFile(int fd)
+    {
+        _close(fd);
+    }
+#else
+    int openFile(const std::string &path, bool append)
+    {
+        return open(path.c_str(),
+                    append ? (O_WRONLY | O_APPEND | O_CREAT) : O_RDWR, 0644);
+    }
+
+    long long writeFile(int fd, const char *data, std::size_t size)
+    {
+        return write(fd, data, size);
+    }
+
+    long long readAt(int fd, char *data, std::size_t size, long long offset)
+    {
+        return pread(fd, data, size, static_cast<off_t>(offset));
+    }
+
+    long long fileSize(int fd)
+    {
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            return -1;
+        }
+        return st.st_size;
+    }
+
+    bool syncFile(int fd)
+    {
+        return fsync(fd) == 0;
+    }
+
+    void closeFile(int fd)
+    {
+        close(fd);
+    }
+#endif
+}
+
+IncrementalFileWriter::IncrementalFileWriter(const std::string &path,
+                                             int syncInterval)
+    : fd(-1), path(path), syncInterval(syncInterval), stopping(false),
+      flushRequested(0), flushDone(0), failed(false)
+{
+    recovered = recover(path);
+
+    fd = openFile(path, true);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not open file: " + path);
+    }
+
+    writeThread = std::thread(&IncrementalFileWriter::writeLoop, this);
+}
+
+IncrementalFileWriter::~IncrementalFileWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCond.notify_one();
+    writeThread.join();
+
+    closeFile(fd);
+}
+
+bool IncrementalFileWriter::append(const std::string &text)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (failed)
+        {
+            return false;
+        }
+        pending += text;
+    }
+
+    // the writer wakes up by itself every flushInterval, so there's no need
+    // to notify it for every line
+    return true;
+}
+
+bool IncrementalFileWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    const std::uint64_t request = ++flushRequested;
+    queueCond.notify_one();
+    flushedCond.wait(lock, [&]() { return flushDone >= request; });
+    return !failed;
+}
+
+bool IncrementalFileWriter::hasFailed()
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return failed;
+}
+
+std::uint64_t IncrementalFileWriter::getRecoveredBytes() const
+{
+    return recovered;
+}
+
+bool IncrementalFileWriter::writeOut(const std::string &data)
+{
+    std::size_t written = 0;
+    while (written < data.size())
+    {
+        long long n = writeFile(fd, data.data() + written, data.size() - written);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<std::size_t>(n);
+    }
+
+    return true;
+}
+
+bool IncrementalFileWriter::sync()
+{
+    return syncInterval == syncNever || syncFile(fd);
+}
+
+void IncrementalFileWriter::writeLoop()
+{
+    std::string batch;
+    bool unsynced = false;
+    std::chrono::steady_clock::time_point lastSync = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true)
+    {
+        queueCond.wait_for(lock, flushInterval, [&]() {
+            return stopping || flushRequested != flushDone;
+        });
+
+        const bool stop = stopping;
+        const std::uint64_t request = flushRequested;
+        batch.swap(pending);
+
+        // do the I/O without holding up append()
+        lock.unlock();
+
+        bool ok = true;
+        if (!batch.empty())
+        {
+            ok = writeOut(batch);
+            unsynced = true;
+            batch.clear();
+        }
+
+        // sync after every batch, at the interval, or when asked to
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (ok && unsynced
+            && (syncInterval == syncEveryBatch || stop || request != flushDone
+                || (syncInterval > 0
+                    && now - lastSync >= std::chrono::milliseconds(syncInterval))))
+        {
+            ok = sync();
+            unsynced = false;
+            lastSync = now;
+        }
+
+        lock.lock();
+        if (!ok)
+        {
+            failed = true;
+        }
+        if (request != flushDone)
+        {
+            flushDone = request;
+            flushedCond.notify_all();
+        }
+        if (stop && pending.empty())
+        {
+            break;
+        }
+    }
+}
+
+std::uint64_t IncrementalFileWriter::recover(const std::string &path)
+{
+    int fd = openFile(path, false);
+    if (fd < 0)
+    {
+        // nothing to repair
+        return 0;
+    }
+
+    const long long size = fileSize(fd);
+    if (size <= 0)
+    {
+        closeFile(fd);
+        return 0;
+    }
+
+    // look backwards for the last newline
+    std::vector<char> chunk(4096);
+    long long end = size;
+    long long keep = 0;
+    bool found = false;
+    while (end > 0 && !found)
+    {
+        const long long start = (end > static_cast<long long>(chunk.size())
+                                 ? end - static_cast<long long>(chunk.size()) : 0);
+        const std::size_t length = static_cast<std::size_t>(end - start);
+        if (readAt(fd, chunk.data(), length, start) != static_cast<long long>(length))
+        {
+            closeFile(fd);
+            throw std::runtime_error("Could not read file: " + path);
+        }
+
+        for (std::size_t i = length; i > 0; --i)
+        {
+            if (chunk[i - 1] == '\n')
+            {
+                keep = start + static_cast<long long>(i);
+                found = true;
+                break;
+            }
+        }
+        end = start;
+    }
+
+    closeFile(fd);
+    if (keep == size)
+    {
+        return 0;
+    }
+
+    // end the line, so it's kept as it is and new rows start on their own
+    fd = openFile(path, true);
+    if (fd < 0 || writeFile(fd, "\n", 1) != 1)
+    {
+        if (fd >= 0)
+        {
+            closeFile(fd);
+        }
+        throw std::runtime_error("Could not repair file: " + path);
+    }
+    closeFile(fd);
+
+    return static_cast<std::uint64_t>(size - keep);
+}
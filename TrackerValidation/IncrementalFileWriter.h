@@ -0,0 +1,90 @@
+// Append-only file writer which persists data as it goes.
+// Text is queued by append(), which only copies it, and a background thread
+// writes it out in batches and forces it to disk according to the sync
+// policy. If the program crashes or loses power, at most the last batch (or
+// sync interval) of data is lost, rather than the whole session.
+
+#ifndef INCREMENTALFILEWRITER_H
+#define INCREMENTALFILEWRITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class IncrementalFileWriter
+{
+  public:
+    // sync policies (values of syncInterval)
+    static constexpr int syncNever = -1;      // leave it to the OS
+    static constexpr int syncEveryBatch = 0;  // after every batch written
+
+    // longest time text waits in the queue before being written
+    static constexpr std::chrono::milliseconds flushInterval{100};
+
+  private:
+    int fd;
+    std::string path;
+    int syncInterval;
+
+    // length of the unterminated last line ended when opening
+    std::uint64_t recovered;
+
+    std::mutex queueMutex;
+    std::condition_variable queueCond;   // writer thread waits on this
+    std::condition_variable flushedCond; // flush() waits on this
+    std::string pending;                 // appended but not yet written
+    bool stopping;
+    std::uint64_t flushRequested;
+    std::uint64_t flushDone;
+    bool failed;
+
+    std::thread writeThread;
+
+    void writeLoop();
+
+    // write everything in data, and sync if requested
+    // @returns false on error
+    bool writeOut(const std::string &data);
+    bool sync();
+
+  public:
+    // Open a file for appending, creating it if needed. An unterminated last
+    // line (e.g. from a crash part way through a write) is ended first.
+    // @param syncInterval syncNever, syncEveryBatch, or the minimum ms
+    //        between syncs
+    // @throws std::runtime_error if the file could not be opened
+    explicit IncrementalFileWriter(const std::string &path,
+                                   int syncInterval = syncEveryBatch);
+
+    // writes out everything appended
+    ~IncrementalFileWriter();
+
+    IncrementalFileWriter(const IncrementalFileWriter &) = delete;
+    IncrementalFileWriter &operator=(const IncrementalFileWriter &) = delete;
+
+    // Queue text to be written. This never waits for I/O.
+    // @returns false if an earlier write failed (the text is dropped)
+    bool append(const std::string &text);
+
+    // Write out and sync everything appended so far, and wait for it.
+    // @returns false if any write has failed
+    bool flush();
+
+    // Has a write failed?
+    bool hasFailed();
+
+    // Length of the unterminated last line ended when the file was opened.
+    std::uint64_t getRecoveredBytes() const;
+
+    // End an unterminated last line of a file with a newline, so anything
+    // appended starts on a line of its own. Nothing is removed, as the line
+    // may not be ours. The file is left alone if it doesn't exist.
+    // @returns the length of the line which was ended (0 if none)
+    // @throws std::runtime_error if the file could not be repaired
+    static std::uint64_t recover(const std::string &path);
+};
+
+#endif // not defined INCREMENTALFILEWRITER_H
@@ -43,7 +43,8 @@ MeasuredData *MeasuredData::create(const std::string &type,
                                    const std::string &label,
                                    const std::string &trackerName,
                                    const std::string &subject,
-                                   std::string path)
+                                   std::string path,
+                                   int syncInterval)
 {
     if (type == "cout")
     {
@@ -51,7 +52,8 @@ MeasuredData *MeasuredData::create(const std::string &type,
     }
     else if (type == "file")
     {
-        return new MeasuredDataFile(label, trackerName, subject, path);
+        return new MeasuredDataFile(label, trackerName, subject, path,
+                                    syncInterval);
     }
     else
     {
@@ -4,6 +4,10 @@
 #ifndef MEASUREDDATA_H
 #define MEASUREDDATA_H
 
+#include "DisplayTiming.h"
+#include "FixationDetector.h"
+#include "GazeWindowStats.h"
+
 #include <chrono>
 #include <string>
 
@@ -33,6 +37,11 @@ class MeasuredData
     virtual ~MeasuredData();
 
     // Write the data to the buffer or datastore (whatever that may be)
+    // gazeAge is how old the gaze sample was (ms since the tracker took it)
+    // when the measurement was made, window summarises the gaze over the
+    // measurement window, fixation is the fixation made on the target
+    // (nullptr if there wasn't one), and onset is when the target appeared
+    // (nullptr if it isn't known).
     virtual bool writeData(
         std::chrono::time_point<std::chrono::system_clock> timestamp,
         unsigned int targetNumber,
@@ -43,7 +52,11 @@ class MeasuredData
         unsigned int xActualRight,
         unsigned int yActualRight,
         unsigned int xActualLeft,
-        unsigned int yActualLeft) = 0;
+        unsigned int yActualLeft,
+        double gazeAge,
+        const GazeWindowStats &window,
+        const Fixation *fixation,
+        const TargetOnset *onset) = 0;
 
     // If using a buffer, write the buffered data to the datastore. If not
     // overloaded, this method is a no-op.
@@ -52,11 +65,14 @@ class MeasuredData
     // create a data store of the given type.
     // @throws std::runtime_error if type does not match a known type.
     // @param path the filesystem path to the store, or "" if not applicable
+    // @param syncInterval for files, how often data is forced to disk (see
+    //        IncrementalFileWriter)
     static MeasuredData *create(const std::string &type,
                                 const std::string &label,
                                 const std::string &trackerName,
                                 const std::string &subject,
-                                std::string path = "");
+                                std::string path = "",
+                                int syncInterval = 0);
 
     // -- getters -- //
     const std::string &getLabel(void) const;
@@ -0,0 +1,185 @@
+// Asynchronous measured data storage.
+
+#include "MeasuredDataAsync.h"
+
+#include <iostream>
+#include <stdexcept>
+
+MeasuredDataAsync::MeasuredDataAsync(MeasuredData *store, std::size_t capacity)
+    : MeasuredData(store->getLabel(), store->getTrackerName(), store->getSubject()),
+      store(store), capacity(capacity), writing(false), stopping(false), failed(false),
+      stats(), totalLatency(0.0)
+{
+    if (capacity == 0)
+    {
+        delete store;
+        throw std::runtime_error("Measurement buffer capacity must be positive");
+    }
+
+    front.reserve(capacity);
+    back.reserve(capacity);
+
+    writeThread = std::thread(&MeasuredDataAsync::writeLoop, this);
+}
+
+MeasuredDataAsync::~MeasuredDataAsync()
+{
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        stopping = true;
+    }
+    bufferCond.notify_one();
+    writeThread.join();
+
+    delete store;
+}
+
+bool MeasuredDataAsync::writeData(
+    std::chrono::time_point<std::chrono::system_clock> timestamp,
+    unsigned int targetNumber,
+    unsigned int xTarget, unsigned int yTarget,
+    unsigned int xCursor, unsigned int yCursor,
+    unsigned int xActualRight, unsigned int yActualRight,
+    unsigned int xActualLeft, unsigned int yActualLeft,
+    double gazeAge,
+    const GazeWindowStats &window,
+    const Fixation *fixation,
+    const TargetOnset *onset)
+{
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        if (failed || front.size() >= capacity)
+        {
+            ++stats.rejected;
+            return false;
+        }
+
+        Record r;
+        r.timestamp = timestamp;
+        r.targetNumber = targetNumber;
+        r.xTarget = xTarget;
+        r.yTarget = yTarget;
+        r.xCursor = xCursor;
+        r.yCursor = yCursor;
+        r.xActualRight = xActualRight;
+        r.yActualRight = yActualRight;
+        r.xActualLeft = xActualLeft;
+        r.yActualLeft = yActualLeft;
+        r.gazeAge = gazeAge;
+        r.window = window;
+        r.haveFixation = (fixation != nullptr);
+        if (fixation != nullptr)
+        {
+            r.fixation = *fixation;
+        }
+        r.haveOnset = (onset != nullptr);
+        if (onset != nullptr)
+        {
+            r.onset = *onset;
+        }
+        r.queuedAt = std::chrono::steady_clock::now();
+        front.push_back(r);
+
+        ++stats.queued;
+        const std::size_t depth = front.size() + (writing ? back.size() : 0);
+        if (depth > stats.maxDepth)
+        {
+            stats.maxDepth = depth;
+        }
+    }
+    bufferCond.notify_one();
+
+    return true;
+}
+
+void MeasuredDataAsync::writeLoop()
+{
+    std::unique_lock<std::mutex> lock(bufferMutex);
+    while (true)
+    {
+        bufferCond.wait(lock, [&]() { return stopping || !front.empty(); });
+        if (front.empty())
+        {
+            // stopping, and nothing left to write
+            break;
+        }
+
+        front.swap(back);
+        writing = true;
+        lock.unlock();
+
+        // format and store the batch without holding up writeData()
+        std::uint64_t written = 0;
+        double latency = 0.0, maxLatency = 0.0;
+        for (const Record &r : back)
+        {
+            if (store->writeData(r.timestamp, r.targetNumber,
+                                 r.xTarget, r.yTarget, r.xCursor, r.yCursor,
+                                 r.xActualRight, r.yActualRight,
+                                 r.xActualLeft, r.yActualLeft,
+                                 r.gazeAge, r.window,
+                                 (r.haveFixation ? &r.fixation : nullptr),
+                                 (r.haveOnset ? &r.onset : nullptr)))
+            {
+                ++written;
+            }
+
+            const double l = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - r.queuedAt).count();
+            latency += l;
+            if (l > maxLatency)
+            {
+                maxLatency = l;
+            }
+        }
+
+        lock.lock();
+        stats.written += written;
+        stats.failed += back.size() - written;
+        if (written != back.size())
+        {
+            failed = true;
+        }
+        totalLatency += latency;
+        if (maxLatency > stats.maxLatency)
+        {
+            stats.maxLatency = maxLatency;
+        }
+        back.clear();
+        writing = false;
+        idleCond.notify_all();
+    }
+}
+
+void MeasuredDataAsync::writeBuffer()
+{
+    {
+        std::unique_lock<std::mutex> lock(bufferMutex);
+        idleCond.wait(lock, [&]() { return front.empty() && !writing; });
+    }
+
+    store->writeBuffer();
+}
+
+MeasuredDataAsync::Stats MeasuredDataAsync::getStats()
+{
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    Stats s = stats;
+    s.depth = front.size() + (writing ? back.size() : 0);
+    const std::uint64_t done = stats.written + stats.failed;
+    s.meanLatency = (done > 0 ? totalLatency / done : 0.0);
+    return s;
+}
+
+std::ostream &operator<<(std::ostream &str, const MeasuredDataAsync::Stats &stats)
+{
+    str << "measurements queued " << stats.queued
+        << ", written " << stats.written
+        << ", failed " << stats.failed
+        << ", rejected " << stats.rejected
+        << ", waiting " << stats.depth
+        << " (max " << stats.maxDepth << ")"
+        << ", latency mean " << stats.meanLatency
+        << " ms, max " << stats.maxLatency << " ms";
+    return str;
+}
@@ -0,0 +1,123 @@
+// Asynchronous measured data storage.
+// Wraps another MeasuredData so writeData() only copies the measurement into
+// a pre-allocated buffer and returns. A writer thread swaps the buffers over
+// and passes the batch to the wrapped store, so formatting and I/O never
+// hold up the caller (which may be holding locks the collector wants).
+
+#ifndef MEASUREDDATAASYNC_H
+#define MEASUREDDATAASYNC_H
+
+#include "DisplayTiming.h"
+#include "FixationDetector.h"
+#include "GazeWindowStats.h"
+#include "MeasuredData.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class MeasuredDataAsync : public MeasuredData
+{
+  public:
+    // default number of measurements each buffer holds
+    static constexpr std::size_t defaultCapacity = 256;
+
+    struct Stats
+    {
+        std::uint64_t queued;    // measurements accepted
+        std::uint64_t written;   // measurements the wrapped store accepted
+        std::uint64_t failed;    // measurements the wrapped store rejected
+        std::uint64_t rejected;  // measurements dropped as the buffer was full,
+                                 // or after the wrapped store failed
+        std::size_t depth;       // measurements waiting now
+        std::size_t maxDepth;    // most measurements ever waiting
+
+        // time from writeData() to the wrapped store finishing with it (ms)
+        double meanLatency;
+        double maxLatency;
+    };
+
+  private:
+    // everything writeData() is given, as plain data
+    struct Record
+    {
+        std::chrono::time_point<std::chrono::system_clock> timestamp;
+        unsigned int targetNumber;
+        unsigned int xTarget, yTarget;
+        unsigned int xCursor, yCursor;
+        unsigned int xActualRight, yActualRight;
+        unsigned int xActualLeft, yActualLeft;
+        double gazeAge;
+        GazeWindowStats window;
+        bool haveFixation;
+        Fixation fixation;
+        bool haveOnset;
+        TargetOnset onset;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    MeasuredData *store;
+    std::size_t capacity;
+
+    // filled by writeData(), and being written by the writer thread. Both
+    // are reserved up front and only ever swapped.
+    std::vector<Record> front;
+    std::vector<Record> back;
+
+    std::mutex bufferMutex;
+    std::condition_variable bufferCond; // the writer waits on this
+    std::condition_variable idleCond;   // writeBuffer() waits on this
+    bool writing; // is the writer busy with back?
+    bool stopping;
+    bool failed; // has the wrapped store rejected a measurement?
+    Stats stats;
+    double totalLatency;
+
+    std::thread writeThread;
+
+    void writeLoop();
+
+  public:
+    // Takes ownership of store.
+    // @param capacity measurements each buffer can hold. If the writer
+    //        falls this far behind, measurements are rejected.
+    explicit MeasuredDataAsync(MeasuredData *store,
+                               std::size_t capacity = defaultCapacity);
+
+    // writes everything queued, then deletes the wrapped store
+    ~MeasuredDataAsync();
+
+    MeasuredDataAsync(const MeasuredDataAsync &) = delete;
+    MeasuredDataAsync &operator=(const MeasuredDataAsync &) = delete;
+
+    // Queue a measurement. This never waits for the wrapped store.
+    // @returns false if the buffer is full, or if the wrapped store has
+    //          failed to write an earlier measurement (e.g. the disk is
+    //          full), as later ones won't be saved either
+    bool writeData(
+        std::chrono::time_point<std::chrono::system_clock> timestamp,
+        unsigned int targetNumber,
+        unsigned int xTarget, unsigned int yTarget,
+        unsigned int xCursor, unsigned int yCursor,
+        unsigned int xActualRight, unsigned int yActualRight,
+        unsigned int xActualLeft, unsigned int yActualLeft,
+        double gazeAge,
+        const GazeWindowStats &window,
+        const Fixation *fixation,
+        const TargetOnset *onset);
+
+    // Wait for everything queued to be written, then write the wrapped
+    // store's buffer.
+    void writeBuffer();
+
+    Stats getStats();
+
+    friend std::ostream &operator<<(std::ostream &str, const Stats &stats);
+};
+
+#endif // defined MEASUREDDATAASYNC_H
@@ -5,39 +5,69 @@
 #include "MeasuredDataFile.h"
 
 #include <iostream>
-#include <fstream>
 
 MeasuredDataFile::MeasuredDataFile(const std::string &label,
                                    const std::string &trackerName,
                                    const std::string &subject,
-                                   const std::string &filePath)
+                                   const std::string &filePath,
+                                   int syncInterval)
     : MeasuredDataStream(label, trackerName, subject, std::cout), // cout as placeholder
-      filePath(filePath)
+      filePath(filePath), writer(filePath, syncInterval)
 {
-    outFile.open(filePath, std::ios::out | std::ios::app);
-
-    if (!outFile.is_open())
+    if (writer.getRecoveredBytes() > 0)
     {
-        throw std::runtime_error("Could not open file: " + filePath);
+        std::cerr << "Warning: the last line of " << filePath << " ("
+                  << writer.getRecoveredBytes() << " bytes) had no newline, so"
+                  << " it may be incomplete. It has been ended with one."
+                  << std::endl;
     }
 
-    finalOutStream = &outFile;
+    // the header
+    sendRows();
 }
 
-MeasuredDataFile::~MeasuredDataFile()
+bool MeasuredDataFile::sendRows()
 {
-    outFile.close();
+    bool success = writer.append(outStream.str());
+
+    // reuse the stream for the next row
+    outStream.str(std::string());
+    outStream.clear();
+
+    return success;
 }
 
-void MeasuredDataFile::writeBuffer()
+bool MeasuredDataFile::writeData(
+    std::chrono::time_point<std::chrono::system_clock> timestamp,
+    unsigned int targetNumber,
+    unsigned int xTarget, unsigned int yTarget,
+    unsigned int xCursor, unsigned int yCursor,
+    unsigned int xActualRight, unsigned int yActualRight,
+    unsigned int xActualLeft, unsigned int yActualLeft,
+    double gazeAge,
+    const GazeWindowStats &window,
+    const Fixation *fixation,
+    const TargetOnset *onset)
 {
-    std::cout << "Writing data to " << filePath << " ... " << std::flush;
+    bool success = MeasuredDataStream::writeData(
+        timestamp, targetNumber, xTarget, yTarget, xCursor, yCursor,
+        xActualRight, yActualRight, xActualLeft, yActualLeft,
+        gazeAge, window, fixation, onset);
 
-    // write the generated data file
-    *finalOutStream << outStream.str() << std::flush;
+    // a failed write means the data isn't safe, so report it to the caller
+    return sendRows() && success;
+}
 
-    // and reset the stream
-    std::stringstream().swap(outStream);
+void MeasuredDataFile::writeBuffer()
+{
+    std::cout << "Writing data to " << filePath << " ... " << std::flush;
 
-    std::cout << "done" << std::endl;
-}
\ No newline at end of file
+    if (writer.flush())
+    {
+        std::cout << "done" << std::endl;
+    }
+    else
+    {
+        std::cout << "failed!" << std::endl;
+    }
+}
@@ -1,30 +1,50 @@
 // Measured data storage written to a file
-// This is essentially a stream class wrapper with a few helpers
+// This is essentially a stream class wrapper with a few helpers. Each row is
+// handed to an IncrementalFileWriter as soon as it is made, so the file is
+// written as the session goes rather than all at the end.
 // Written by Tim Murphy <tim@murphy.org> 2021
 
 #ifndef MEASUREDDATAFILE_H
 #define MEASUREDDATAFILE_H
 
+#include "IncrementalFileWriter.h"
 #include "MeasuredDataStream.h"
 
-#include <fstream>
 #include <string>
 
 class MeasuredDataFile : public MeasuredDataStream
 {
   private:
-    std::ofstream outFile;
     std::string filePath;
+    IncrementalFileWriter writer;
+
+    // pass anything formatted so far to the writer
+    bool sendRows();
 
   public:
+    // @param syncInterval how often the file is forced to disk (see
+    //        IncrementalFileWriter)
+    // @throws std::runtime_error if the file could not be opened
     MeasuredDataFile(const std::string &label,
                      const std::string &trackerName,
                      const std::string &subject,
-                     const std::string &filePath);
-
-    ~MeasuredDataFile();
-
+                     const std::string &filePath,
+                     int syncInterval = IncrementalFileWriter::syncEveryBatch);
+
+    bool writeData(
+        std::chrono::time_point<std::chrono::system_clock> timestamp,
+        unsigned int targetNumber,
+        unsigned int xTarget, unsigned int yTarget,
+        unsigned int xCursor, unsigned int yCursor,
+        unsigned int xActualRight, unsigned int yActualRight,
+        unsigned int xActualLeft, unsigned int yActualLeft,
+        double gazeAge,
+        const GazeWindowStats &window,
+        const Fixation *fixation,
+        const TargetOnset *onset);
+
+    // wait for everything to be written to disk
     void writeBuffer();
 };
 
-#endif // defined MEASUREDDATAFILE_H
\ No newline at end of file
+#endif // defined MEASUREDDATAFILE_H
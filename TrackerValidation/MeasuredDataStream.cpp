@@ -3,7 +3,6 @@
 
 #include "MeasuredDataStream.h"
 
-#include <ctime>
 #include <iomanip>
 #include <iostream>
 
@@ -14,12 +13,28 @@ MeasuredDataStream::MeasuredDataStream(const std::string &label,
     : MeasuredData(label, trackerName, subject), finalOutStream(&str)
 {
     // CSV header
-    outStream << "\"Label\",\"Subject\",\"Tracker\",\"Timestamp\",\"Target-ID\","
+    outStream << "\"Label\",\"Subject\",\"Tracker\","
+              << "\"Timestamp\",\"Timestamp-ns\",\"Target-ID\","
               << "\"Target-X\",\"Target-Y\","
               << "\"Cursor-X\",\"Cursor-Y\","
               << "\"Actual-X-Right\",\"Actual-Y-Right\","
-              << "\"Actual-X-Left\",\"Actual-Y-Left\""
-              << std::endl;
+              << "\"Actual-X-Left\",\"Actual-Y-Left\","
+              << "\"Gaze-Age-ms\"";
+
+    // measurement window statistics
+    static const char * const eyes[] = { "Right", "Left" };
+    for (const char *eye : eyes)
+    {
+        outStream << ",\"Window-N-" << eye << "\","
+                  << "\"Window-Mean-X-" << eye << "\",\"Window-Mean-Y-" << eye << "\","
+                  << "\"Window-Median-X-" << eye << "\",\"Window-Median-Y-" << eye << "\","
+                  << "\"Window-SD-X-" << eye << "\",\"Window-SD-Y-" << eye << "\","
+                  << "\"Window-RMS-S2S-" << eye << "\"";
+    }
+
+    outStream << ",\"Fixation-X\",\"Fixation-Y\","
+              << "\"Fixation-Duration-ms\",\"Fixation-N\","
+              << "\"Onset-Timestamp-ns\",\"Reaction-Time-ms\"" << std::endl;
 }
 
 void MeasuredDataStream::writeBuffer()
@@ -44,26 +59,76 @@ bool MeasuredDataStream::writeData(
     unsigned int xTarget, unsigned int yTarget,
     unsigned int xCursor, unsigned int yCursor,
     unsigned int xActualRight, unsigned int yActualRight,
-    unsigned int xActualLeft, unsigned int yActualLeft)
+    unsigned int xActualLeft, unsigned int yActualLeft,
+    double gazeAge,
+    const GazeWindowStats &window,
+    const Fixation *fixation,
+    const TargetOnset *onset)
 {
-    // format the timestamp
-    std::time_t ts = std::chrono::system_clock::to_time_t(timestamp);
-    struct tm buffer;
-#ifdef _WIN32
-    localtime_s(&buffer, &ts);
-#else
-    localtime_r(&ts, &buffer);
-#endif
+    // local time to the microsecond, and nanoseconds since the epoch for
+    // lining up with other recordings
+    char localTime[TimestampFormatter::maxLength];
+    char epochTime[TimestampFormatter::maxLength];
+    const std::size_t localLength = timestampFormatter.format(timestamp, localTime);
+    const std::size_t epochLength = TimestampFormatter::formatEpochNs(timestamp, epochTime);
 
     outStream << "\"" << getLabel() << "\","
               << "\"" << getSubject() << "\","
-              << "\"" << getTrackerName() << "\","
-              << "\"" << std::put_time(&buffer, "%F %T") << "\","
+              << "\"" << getTrackerName() << "\",\"";
+    outStream.write(localTime, localLength);
+    outStream << "\",";
+    outStream.write(epochTime, epochLength);
+    outStream << ","
               << targetNumber << ","
               << xTarget << "," << yTarget << ","
               << xCursor << "," << yCursor << ","
               << xActualRight << "," << yActualRight << ","
-              << xActualLeft << "," << yActualLeft << std::endl;
+              << xActualLeft << "," << yActualLeft << ","
+              << std::fixed << std::setprecision(3) << gazeAge;
+
+    // the statistics are left empty if there were no valid samples
+    const EyeWindowStats *eyes[] = { &window.right, &window.left };
+    for (const EyeWindowStats *eye : eyes)
+    {
+        outStream << "," << eye->count;
+        if (eye->count > 0)
+        {
+            outStream << std::setprecision(2)
+                      << "," << eye->meanX << "," << eye->meanY
+                      << "," << eye->medianX << "," << eye->medianY
+                      << "," << eye->sdX << "," << eye->sdY
+                      << "," << eye->rmsS2S;
+        }
+        else
+        {
+            outStream << ",,,,,,,";
+        }
+    }
+
+    if (fixation != nullptr)
+    {
+        outStream << std::setprecision(2)
+                  << "," << fixation->x << "," << fixation->y
+                  << "," << fixation->getDuration()
+                  << "," << fixation->count;
+    }
+    else
+    {
+        outStream << ",,,,";
+    }
+
+    if (onset != nullptr)
+    {
+        const std::size_t onsetLength = TimestampFormatter::formatEpochNs(onset->shown, epochTime);
+        outStream << ",";
+        outStream.write(epochTime, onsetLength);
+        outStream << "," << std::setprecision(3) << onset->reactionTime;
+    }
+    else
+    {
+        outStream << ",,";
+    }
+    outStream << std::defaultfloat << std::endl;
 
     return true;
 }
@@ -5,6 +5,7 @@
 #define MEASUREDDATASTREAM_H
 
 #include "MeasuredData.h"
+#include "TimestampFormatter.h"
 
 #include <iosfwd>
 #include <sstream>
@@ -18,6 +19,9 @@ class MeasuredDataStream : public MeasuredData
     // this is where the final data is written
     std::ostream *finalOutStream;
 
+    // formats the timestamp for each row
+    TimestampFormatter timestampFormatter;
+
   public:
     MeasuredDataStream(const std::string &label,
                        const std::string &trackerName,
@@ -30,7 +34,11 @@ class MeasuredDataStream : public MeasuredData
         unsigned int xTarget, unsigned int yTarget,
         unsigned int xCursor, unsigned int yCursor,
         unsigned int xActualRight, unsigned int yActualRight,
-        unsigned int xActualLeft, unsigned int yActualLeft);
+        unsigned int xActualLeft, unsigned int yActualLeft,
+        double gazeAge,
+        const GazeWindowStats &window,
+        const Fixation *fixation,
+        const TargetOnset *onset);
 
     virtual void writeBuffer();
 };
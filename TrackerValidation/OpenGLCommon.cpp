@@ -2,7 +2,7 @@
 
 #include "OpenGLCommon.h"
 
-#include "common.h"
+#include "DisplayGeometry.h"
 
 std::pair<double, double> OpenGLPixelToPosition(int xPixel, int yPixel)
 {
@@ -12,11 +12,7 @@ std::pair<double, double> OpenGLPixelToPosition(int xPixel, int yPixel)
     //  x = 2 x (100/1024) - 1 = -0.80
     //  y = 1 - (2 x (100/768) = 0.74
     //  So returned value would be (-0.80, 0.74)
-    std::pair<unsigned int, unsigned int> res = common::getScreenRes();
-    double xPos = 2 * (static_cast<double>(xPixel)
-                  / static_cast<double>(res.first)) - 1.0;
-    double yPos = 1.0 - (2 * (static_cast<double>(yPixel)
-                  / static_cast<double>(res.second)));
-
-    return std::make_pair(xPos, yPos);
+    // When drawing lots of vertices, get the transform once with
+    // DisplayGeometry::getPixelTransform() instead.
+    return DisplayGeometry::get().getPixelTransform().toPosition(xPixel, yPixel);
 }
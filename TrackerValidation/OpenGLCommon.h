@@ -5,7 +5,8 @@
 
 #include <utility> // for std::pair
 
-// Convert the pixel location to OpenGL relative position [-1.0, 1.0].
+// Convert the pixel location to OpenGL relative position [-1.0, 1.0], using
+// the cached display geometry (see DisplayGeometry).
 // note: pixel positions can be negative - we may want to draw a object which
 //       is partially off screen
 std::pair<double, double> OpenGLPixelToPosition(int pixelX, int pixelY);
@@ -0,0 +1,74 @@
+// Plays back a gaze recording as if it were a live tracker.
+
+#include "ReplayTrackerCollector.h"
+
+#include "GazeRecording.h"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+ReplayTrackerCollector::ReplayTrackerCollector(ScreenPositionStore &store,
+                                               const TrackerConfig &config)
+    : ThreadTrackerCollector(store, config)
+{
+    if (config.replayFile.empty())
+    {
+        throw std::runtime_error("No gaze recording given for the replay tracker");
+    }
+
+    if (config.replaySpeed < 0.0)
+    {
+        throw std::runtime_error("Replay speed must not be negative");
+    }
+}
+
+void ReplayTrackerCollector::collectData()
+{
+    GazeRecordingReader reader(config.replayFile);
+
+    // don't sleep for longer than this, so we notice when we're stopped
+    static const std::chrono::milliseconds maxSleep(50);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Recorded times are relative to the first sample's arrival. They're
+    // scaled to the playback speed, but as fast as possible keeps the
+    // recorded spacing, so sample times still mean something to the
+    // fixation detector, dwell trigger and measurement windows.
+    const double timeScale = (config.replaySpeed > 0.0 ? 1.0 / config.replaySpeed : 1.0);
+    auto replayTime = [&](std::chrono::steady_clock::time_point recorded) {
+        return start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            recorded.time_since_epoch() * timeScale);
+    };
+
+    GazeSample sample;
+    unsigned long long played = 0;
+    while (isRunning() && reader.next(sample))
+    {
+        if (config.replaySpeed > 0.0)
+        {
+            const std::chrono::steady_clock::time_point due = replayTime(sample.arrival);
+
+            while (isRunning() && std::chrono::steady_clock::now() < due)
+            {
+                std::chrono::steady_clock::time_point wake
+                    = std::chrono::steady_clock::now() + maxSleep;
+                std::this_thread::sleep_until(due < wake ? due : wake);
+            }
+        }
+
+        position.setCurrentPositionRightLeft(sample.right, sample.left,
+                                             sample.identifier,
+                                             replayTime(sample.sampleTime));
+        ++played;
+    }
+
+    std::cout << getName() << " finished after " << played << " samples" << std::endl;
+
+    // nothing left to send - wait to be told to stop
+    while (isRunning())
+    {
+        std::this_thread::sleep_for(maxSleep);
+    }
+}
@@ -0,0 +1,31 @@
+// Plays back a gaze recording (see GazeRecording.h) as if it were a live
+// tracker, at the original speed, a multiple of it, or as fast as possible.
+
+#ifndef REPLAYTRACKERCOLLECTOR_H
+#define REPLAYTRACKERCOLLECTOR_H
+
+#include "ThreadTrackerCollector.h"
+
+#include "ScreenPositionStore.h"
+
+#include <string>
+
+class ReplayTrackerCollector
+    : public ThreadTrackerCollector
+{
+  private:
+    void collectData();
+
+  public:
+    // @throws std::runtime_error if no replay file is configured
+    ReplayTrackerCollector(ScreenPositionStore &store,
+                           const TrackerConfig &config);
+
+    const std::string &getName() const
+    {
+        static const std::string name = "Replay";
+        return name;
+    }
+};
+
+#endif // not defined REPLAYTRACKERCOLLECTOR_H
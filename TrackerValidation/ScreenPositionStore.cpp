@@ -7,32 +7,50 @@
 
 #include <iostream> // for operator<<
 
+namespace
+{
+    bool posValid(std::pair<unsigned int, unsigned int> pos)
+    {
+        return (pos.first != common::invalidCoord &&
+                pos.second != common::invalidCoord);
+    }
+}
+
 ScreenPositionStore::ScreenPositionStore(
     std::pair<unsigned int, unsigned int> right,
     std::pair<unsigned int, unsigned int> left,
-    double id)
-        : currentPosRight(right), currentPosLeft(left), identifier(id)
-{}
+    double id,
+    std::size_t historySize)
+        : samples(historySize), listener(nullptr)
+{
+    setCurrentPositionRightLeft(right, left, id);
+}
 
 std::pair<unsigned int, unsigned int>
     ScreenPositionStore::getCurrentPositionSingle() const
 {
+    // take a single sample so both eyes come from the same reading
+    GazeSample s = getLatestSample();
+
     // default values - will be overwritten if we have valid data
     std::pair<unsigned int, unsigned int> currentPos
         = std::make_pair(common::invalidCoord, common::invalidCoord);
 
-    if (rightDataValid() && leftDataValid())
+    if (s.rightValid && s.leftValid)
     {
-        currentPos.first = (currentPosRight.first + currentPosLeft.first) / 2;
-        currentPos.second = (currentPosRight.second + currentPosLeft.second) / 2;
+        // widen before adding so large values don't wrap
+        currentPos.first = static_cast<unsigned int>(
+            (static_cast<unsigned long long>(s.right.first) + s.left.first) / 2);
+        currentPos.second = static_cast<unsigned int>(
+            (static_cast<unsigned long long>(s.right.second) + s.left.second) / 2);
     }
-    else if (rightDataValid())
+    else if (s.rightValid)
     {
-        currentPos = currentPosRight;
+        currentPos = s.right;
     }
-    else if (leftDataValid())
+    else if (s.leftValid)
     {
-        currentPos = currentPosLeft;
+        currentPos = s.left;
     }
 
     return currentPos;
@@ -41,42 +59,93 @@ std::pair<unsigned int, unsigned int>
 std::pair<std::pair<unsigned int, unsigned int>, std::pair<unsigned int, unsigned int> >
     ScreenPositionStore::getCurrentPositionRightLeft() const
 {
-    return std::make_pair(currentPosRight, currentPosLeft);
+    GazeSample s = getLatestSample();
+    return std::make_pair(s.right, s.left);
+}
+
+GazeSample ScreenPositionStore::getLatestSample() const
+{
+    GazeSample s;
+
+    // the constructor always pushes a sample, so this can't fail
+    samples.latest(s);
+
+    return s;
+}
+
+std::size_t ScreenPositionStore::getSamples(
+    std::chrono::steady_clock::time_point from,
+    std::chrono::steady_clock::time_point to,
+    std::vector<GazeSample> &out) const
+{
+    return samples.snapshot(from, to, out);
+}
+
+const GazeSampleBuffer &ScreenPositionStore::getSampleBuffer() const
+{
+    return samples;
 }
 
 // for positions without right and left data, use the same value for both sides
 void ScreenPositionStore::setCurrentPositionSingle(
     std::pair<unsigned int, unsigned int> pos, double id)
 {
-    setCurrentPositionRightLeft(pos, pos);
+    setCurrentPositionRightLeft(pos, pos, id);
 }
 
 void ScreenPositionStore::setCurrentPositionRightLeft(
     std::pair<unsigned int, unsigned int> right,
     std::pair<unsigned int, unsigned int> left, double id)
 {
-    lock();
-    currentPosRight = right;
-    currentPosLeft = left;
-    identifier = id;
-    unlock();
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    setCurrentPositionRightLeft(right, left, id, now);
 }
 
+void ScreenPositionStore::setCurrentPositionRightLeft(
+    std::pair<unsigned int, unsigned int> right,
+    std::pair<unsigned int, unsigned int> left, double id,
+    std::chrono::steady_clock::time_point sampleTime)
+{
+    GazeSample s;
+    s.right = right;
+    s.left = left;
+    s.rightValid = ::posValid(right);
+    s.leftValid = ::posValid(left);
+    s.identifier = id;
+    s.arrival = std::chrono::steady_clock::now();
+    s.sampleTime = sampleTime;
+    s.sequence = samples.pushed(); // we're the only writer
+
+    samples.push(s);
+
+    GazeSampleListener *l = listener.load(std::memory_order_acquire);
+    if (l != nullptr)
+    {
+        l->onSample(s);
+    }
+}
+
+void ScreenPositionStore::setListener(GazeSampleListener *listener)
+{
+    this->listener.store(listener, std::memory_order_release);
+}
+
+GazeSampleListener::~GazeSampleListener()
+{ }
+
 double ScreenPositionStore::getIdentifier() const
 {
-    return identifier;
+    return getLatestSample().identifier;
 }
 
 bool ScreenPositionStore::rightDataValid() const
 {
-    return (currentPosRight.first != common::invalidCoord &&
-            currentPosRight.second != common::invalidCoord); 
+    return getLatestSample().rightValid;
 }
 
 bool ScreenPositionStore::leftDataValid() const
 {
-    return (currentPosLeft.first != common::invalidCoord &&
-            currentPosLeft.second != common::invalidCoord);
+    return getLatestSample().leftValid;
 }
 
 std::ostream &operator<<(std::ostream &os,
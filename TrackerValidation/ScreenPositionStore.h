@@ -1,54 +1,83 @@
 // Class for manual storage of screen (x,y) pixel coordinates.
 // The source of this data could be a TCP stream, FIFO, file, etc.
-// This is defined as a "store" as it refers to the last known value.
+// This is defined as a "store" as it refers to the last known value. Every
+// value set is also kept in a lock-free history buffer, so recent samples can
+// be retrieved by time range.
 // Written by Tim Murphy <tim@murphy.org> 2021
 
 #ifndef SCREENPOSITIONSTORE_H
 #define SCREENPOSITIONSTORE_H
 
 #include "common.h"
+#include "GazeSampleBuffer.h"
 
+#include <atomic>
+#include <chrono>
 #include <iosfwd> // for operator<<
 #include <mutex>
 #include <utility> // for std::pair
+#include <vector>
+
+// Notified of every sample set on a ScreenPositionStore, on the thread that
+// set it (usually a tracker data collector). Implementations must be quick
+// and must not block, as they hold up the tracker.
+class GazeSampleListener
+{
+  public:
+    virtual ~GazeSampleListener();
+
+    virtual void onSample(const GazeSample &sample) = 0;
+};
 
 class ScreenPositionStore
 {
   protected:
-    // Current position (x, y) screen co-ordinates, in pixels
-    std::pair<unsigned int, unsigned int> currentPosRight;
-    std::pair<unsigned int, unsigned int> currentPosLeft;
-
-    // Some trackers will give an identifier (sequence number, time, etc.).
-    // If no identifier is given, it will default to zero.
-    double identifier;
+    // History of positions, newest last. The current position is the newest
+    // sample in here.
+    GazeSampleBuffer samples;
 
-    // position information is written by one thread and retrieved by another.
+    // Not used to protect the position data (which is lock-free), but
+    // available to callers who want to group several actions together.
     std::mutex posMutex;
 
+    // notified of each new sample, or nullptr
+    std::atomic<GazeSampleListener *> listener;
+
   public:
       ScreenPositionStore(
           std::pair<unsigned int, unsigned int> right
             = std::make_pair(common::invalidCoord, common::invalidCoord),
           std::pair<unsigned int, unsigned int> left
             = std::make_pair(common::invalidCoord, common::invalidCoord),
-          double id = 0.0);
+          double id = 0.0,
+          std::size_t historySize = GazeSampleBuffer::defaultCapacity);
 
     // Retrieve the stored position. If we only have data for one eye, that
     // data will be returned. If we have data for both, an average will be
     // returned instead.
-    // Note that this is only thread safe if called within a lock() / unlock()
-    // block. Locking hasn't been done within this method as we may want to
-    // call getIdentifier() or do some other action within the same lock.
+    // This is thread safe and will not block the writer.
     std::pair<unsigned int, unsigned int> getCurrentPositionSingle() const;
 
     // Retrieve the stored position of both eyes.
-    // Note that this is only thread safe if called within a lock() / unlock()
-    // block. Locking hasn't been done within this method as we may want to
-    // call getIdentifier() or do some other action within the same lock.
+    // This is thread safe and will not block the writer. If you also need
+    // the identifier or validity of the same sample, use getLatestSample().
     std::pair<std::pair<unsigned int, unsigned int>, std::pair<unsigned int, unsigned int> >
         getCurrentPositionRightLeft() const;
 
+    // Retrieve the newest sample (positions, validity, identifier and arrival
+    // time all from the same reading).
+    GazeSample getLatestSample() const;
+
+    // Retrieve all samples which arrived in the range [from, to], oldest
+    // first. Samples older than the history size will not be available.
+    // @returns the number of samples copied into out
+    std::size_t getSamples(std::chrono::steady_clock::time_point from,
+                           std::chrono::steady_clock::time_point to,
+                           std::vector<GazeSample> &out) const;
+
+    // Direct access to the sample history.
+    const GazeSampleBuffer &getSampleBuffer() const;
+
     // Do we have valid readings:
     bool rightDataValid() const;
 
@@ -59,14 +88,28 @@ class ScreenPositionStore
     double getIdentifier() const;
 
     // set the position with (x, y) co-ordinates (single value)
+    // Only one thread should set positions on a given store.
     void setCurrentPositionSingle(std::pair<unsigned int, unsigned int> pos,
         double id = 0.0);
 
     // set the position with (x, y) co-ordinates (right and left eyes)
+    // Only one thread should set positions on a given store.
     void setCurrentPositionRightLeft(std::pair<unsigned int, unsigned int> right,
                                      std::pair<unsigned int, unsigned int> left,
                                      double id = 0.0);
 
+    // as above, with the host time the tracker took the sample (see
+    // TrackerClock). If this isn't given, the arrival time is used.
+    void setCurrentPositionRightLeft(std::pair<unsigned int, unsigned int> right,
+                                     std::pair<unsigned int, unsigned int> left,
+                                     double id,
+                                     std::chrono::steady_clock::time_point sampleTime);
+
+    // Set the listener to notify of every new sample, or nullptr for none.
+    // The old listener may still be called by a sample being set at the
+    // same time, so stop the writer before destroying it.
+    void setListener(GazeSampleListener *listener);
+
     friend std::ostream &operator<<(std::ostream &os,
                                     const ScreenPositionStore &store);
 
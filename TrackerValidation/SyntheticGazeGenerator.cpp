@@ -0,0 +1,160 @@
+// Generator for synthetic gaze data with known ground truth.
+
+#include "SyntheticGazeGenerator.h"
+
+#include "common.h"
+
+#include <cmath>
+#include <stdexcept>
+
+SyntheticGazeModel::SyntheticGazeModel()
+    : blinkRate(15.0), blinkDuration(150.0), seed(1)
+{
+    right.offsetX = 5.0;
+    right.offsetY = -3.0;
+    right.driftX = 0.0;
+    right.driftY = 0.0;
+    right.whiteNoise = 2.0;
+    right.pinkNoise = 4.0;
+    right.dropoutRate = 0.001;
+
+    left = right;
+    left.offsetX = -4.0;
+    left.offsetY = 2.0;
+}
+
+SyntheticGazeGenerator::PinkNoise::PinkNoise()
+    : sum(0.0), counter(0)
+{
+    for (unsigned int i = 0; i < rows; ++i)
+    {
+        values[i] = 0.0;
+    }
+}
+
+double SyntheticGazeGenerator::PinkNoise::next(
+    std::mt19937 &rng, std::normal_distribution<double> &white)
+{
+    if (counter == 0)
+    {
+        // fill every row to start with, or the first samples will be quiet
+        for (unsigned int i = 0; i < rows; ++i)
+        {
+            values[i] = white(rng);
+            sum += values[i];
+        }
+    }
+    else
+    {
+        // row k is updated every 2^(k+1) samples
+        unsigned int k = 0;
+        for (std::uint64_t c = counter; (c & 1) == 0 && k < rows - 1; c >>= 1)
+        {
+            ++k;
+        }
+
+        sum -= values[k];
+        values[k] = white(rng);
+        sum += values[k];
+    }
+    ++counter;
+
+    return (sum + white(rng)) / std::sqrt(static_cast<double>(rows + 1));
+}
+
+SyntheticGazeGenerator::SyntheticGazeGenerator(const SyntheticGazeModel &model,
+                                               unsigned int sampleRate)
+    : model(model), sampleRate(sampleRate), rng(model.seed),
+      normal(0.0, 1.0), uniform(0.0, 1.0), count(0), blinkRemaining(0)
+{
+    if (sampleRate == 0)
+    {
+        throw std::runtime_error("Synthetic gaze sample rate must be positive");
+    }
+}
+
+unsigned int SyntheticGazeGenerator::distort(double truth, double offset,
+                                             double drift, double white,
+                                             double pinkSD, PinkNoise &pinkNoise)
+{
+    double seconds = static_cast<double>(count) / sampleRate;
+    double value = truth + offset + drift * seconds;
+
+    if (white > 0.0)
+    {
+        value += white * normal(rng);
+    }
+
+    if (pinkSD > 0.0)
+    {
+        value += pinkSD * pinkNoise.next(rng, normal);
+    }
+
+    // off the top/left of the screen can't be represented
+    if (value < 0.0)
+    {
+        return common::invalidCoord;
+    }
+
+    return static_cast<unsigned int>(std::lround(value));
+}
+
+double SyntheticGazeGenerator::next(std::pair<double, double> truth,
+                                    std::pair<unsigned int, unsigned int> &right,
+                                    std::pair<unsigned int, unsigned int> &left)
+{
+    const std::pair<unsigned int, unsigned int> invalid
+        = std::make_pair(common::invalidCoord, common::invalidCoord);
+
+    const SyntheticEyeModel *eyes[2] = { &model.right, &model.left };
+    std::pair<unsigned int, unsigned int> *out[2] = { &right, &left };
+
+    // always generate the noise and make the same random draws, so blinks
+    // and dropouts don't change the rest of the stream for a given seed
+    for (unsigned int eye = 0; eye < 2; ++eye)
+    {
+        const SyntheticEyeModel &m = *eyes[eye];
+        out[eye]->first = distort(truth.first, m.offsetX, m.driftX,
+                                  m.whiteNoise, m.pinkNoise, pink[eye][0]);
+        out[eye]->second = distort(truth.second, m.offsetY, m.driftY,
+                                   m.whiteNoise, m.pinkNoise, pink[eye][1]);
+
+        if (uniform(rng) < m.dropoutRate
+            || out[eye]->first == common::invalidCoord
+            || out[eye]->second == common::invalidCoord)
+        {
+            *out[eye] = invalid;
+        }
+    }
+
+    // blinks are a Poisson process, and take out both eyes
+    double blinkDraw = uniform(rng);
+    if (blinkRemaining == 0 && model.blinkRate > 0.0
+        && blinkDraw < model.blinkRate / (60.0 * sampleRate))
+    {
+        blinkRemaining = static_cast<std::uint64_t>(
+            std::ceil(model.blinkDuration * sampleRate / 1000.0));
+    }
+
+    if (blinkRemaining > 0)
+    {
+        --blinkRemaining;
+        right = invalid;
+        left = invalid;
+    }
+
+    double time = static_cast<double>(count) * 1000.0 / sampleRate;
+    ++count;
+
+    return time;
+}
+
+unsigned int SyntheticGazeGenerator::getSampleRate() const
+{
+    return sampleRate;
+}
+
+std::uint64_t SyntheticGazeGenerator::getCount() const
+{
+    return count;
+}
@@ -0,0 +1,103 @@
+// Generator for synthetic gaze data with known ground truth.
+// Each call to next() produces one binocular sample at a fixed sample rate.
+// The true gaze position is distorted by a per-eye systematic offset, linear
+// drift, white (Gaussian) noise and pink (1/f) noise, and samples are lost to
+// blinks (both eyes) and random dropouts (one eye). The same seed will always
+// produce the same stream.
+
+#ifndef SYNTHETICGAZEGENERATOR_H
+#define SYNTHETICGAZEGENERATOR_H
+
+#include <cstdint>
+#include <random>
+#include <utility> // for std::pair
+
+// Error model for a single eye. All distances are in pixels.
+struct SyntheticEyeModel
+{
+    double offsetX;
+    double offsetY;
+
+    // drift in pixels per second, starting from zero at the first sample
+    double driftX;
+    double driftY;
+
+    // standard deviation of the white and pink noise added to each axis
+    double whiteNoise;
+    double pinkNoise;
+
+    // probability that any given sample is lost for this eye only
+    double dropoutRate;
+};
+
+struct SyntheticGazeModel
+{
+    SyntheticEyeModel right;
+    SyntheticEyeModel left;
+
+    // blinks per minute, and how long each one lasts (ms)
+    double blinkRate;
+    double blinkDuration;
+
+    std::uint32_t seed;
+
+    // a small amount of noise and the odd blink - roughly a good tracker
+    SyntheticGazeModel();
+};
+
+class SyntheticGazeGenerator
+{
+  private:
+    // Pink noise with unit standard deviation, using the Voss-McCartney
+    // algorithm: a sum of white noise sources updated at halving rates.
+    class PinkNoise
+    {
+      private:
+        static const unsigned int rows = 16;
+        double values[rows];
+        double sum;
+        std::uint64_t counter;
+
+      public:
+        PinkNoise();
+        double next(std::mt19937 &rng, std::normal_distribution<double> &white);
+    };
+
+    SyntheticGazeModel model;
+    unsigned int sampleRate;
+
+    std::mt19937 rng;
+    std::normal_distribution<double> normal;
+    std::uniform_real_distribution<double> uniform;
+
+    // x and y for each eye (right, left)
+    PinkNoise pink[2][2];
+
+    // number of samples generated so far
+    std::uint64_t count;
+
+    // samples left in the current blink (0 if not blinking)
+    std::uint64_t blinkRemaining;
+
+    // one axis of one eye, or common::invalidCoord if off screen
+    unsigned int distort(double truth, double offset, double drift,
+                         double white, double pinkSD, PinkNoise &pinkNoise);
+
+  public:
+    SyntheticGazeGenerator(const SyntheticGazeModel &model,
+                           unsigned int sampleRate);
+
+    // Generate the next sample for the given true gaze position (pixels).
+    // Lost data is set to (common::invalidCoord, common::invalidCoord).
+    // @returns the sample time in ms since the first sample
+    double next(std::pair<double, double> truth,
+                std::pair<unsigned int, unsigned int> &right,
+                std::pair<unsigned int, unsigned int> &left);
+
+    unsigned int getSampleRate() const;
+
+    // number of samples generated so far
+    std::uint64_t getCount() const;
+};
+
+#endif // not defined SYNTHETICGAZEGENERATOR_H
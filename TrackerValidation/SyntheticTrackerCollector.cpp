@@ -0,0 +1,85 @@
+// A simulated gaze tracker, for testing without hardware.
+
+#include "SyntheticTrackerCollector.h"
+
+#include "common.h"
+#include "DisplayGeometry.h"
+#include "TrackerClock.h"
+
+#include <chrono>
+#include <iostream>
+
+SyntheticTrackerCollector::SyntheticTrackerCollector(
+    ScreenPositionStore &store, const TrackerConfig &config,
+    const SyntheticGazeModel &model)
+        : ThreadTrackerCollector(store, config), model(model)
+{ }
+
+unsigned int SyntheticTrackerCollector::getSampleRate() const
+{
+    if (config.sampleRate == 0)
+    {
+        return defaultSampleRate;
+    }
+
+    return (config.sampleRate > maxSampleRate ? maxSampleRate : config.sampleRate);
+}
+
+void SyntheticTrackerCollector::collectData()
+{
+    const unsigned int rate = getSampleRate();
+    if (rate != config.sampleRate && config.sampleRate != 0)
+    {
+        std::cerr << getName() << " tracker sample rate limited to " << rate
+                  << " Hz" << std::endl;
+    }
+
+    SyntheticGazeGenerator generator(model, rate);
+
+    // sample times are in ms, like a real tracker
+    TrackerClock clock(1000.0);
+
+    // gaze defaults to the middle of the screen
+    const std::pair<unsigned int, unsigned int> res = DisplayGeometry::get().getResolution();
+    const std::pair<double, double> centre = std::make_pair(res.first / 2.0,
+                                                            res.second / 2.0);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Sleeping can't be relied on for intervals below ~1 ms, so on each wake
+    // generate every sample which has become due since the last one. Like a
+    // real tracker, samples will arrive in small bursts at high rates.
+    std::pair<unsigned int, unsigned int> right, left;
+    while (isRunning())
+    {
+        std::chrono::microseconds elapsed
+            = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+        std::uint64_t due = static_cast<std::uint64_t>(elapsed.count())
+                            * rate / 1000000ULL + 1;
+
+        while (generator.getCount() < due)
+        {
+            std::pair<double, double> truth = centre;
+            if (targetPosition != nullptr)
+            {
+                std::pair<unsigned int, unsigned int> target
+                    = targetPosition->getCurrentPositionSingle();
+                if (target.first != common::invalidCoord
+                    && target.second != common::invalidCoord)
+                {
+                    truth = std::make_pair(static_cast<double>(target.first),
+                                           static_cast<double>(target.second));
+                }
+            }
+
+            double time = generator.next(truth, right, left);
+            position.setCurrentPositionRightLeft(
+                right, left, time,
+                clock.update(time, std::chrono::steady_clock::now()));
+        }
+
+        std::this_thread::sleep_until(
+            start + std::chrono::microseconds(due * 1000000ULL / rate));
+    }
+}
@@ -0,0 +1,44 @@
+// A simulated gaze tracker, for testing without hardware.
+// Gaze follows the target being shown (or the middle of the screen if there
+// is no target), distorted by the error model in SyntheticGazeGenerator.
+// Samples are generated in real time at the configured rate.
+
+#ifndef SYNTHETICTRACKERCOLLECTOR_H
+#define SYNTHETICTRACKERCOLLECTOR_H
+
+#include "ThreadTrackerCollector.h"
+
+#include "ScreenPositionStore.h"
+#include "SyntheticGazeGenerator.h"
+
+#include <string>
+
+class SyntheticTrackerCollector
+    : public ThreadTrackerCollector
+{
+  private:
+    SyntheticGazeModel model;
+
+    void collectData();
+
+  public:
+    // sample rate used if none is configured, and the fastest we will go
+    static const unsigned int defaultSampleRate = 1000; // Hz
+    static const unsigned int maxSampleRate = 10000; // Hz
+
+    SyntheticTrackerCollector(ScreenPositionStore &store,
+                              const TrackerConfig &config,
+                              const SyntheticGazeModel &model = SyntheticGazeModel());
+
+    const std::string &getName() const
+    {
+        static const std::string name = "Synthetic";
+        return name;
+    }
+
+    // The rate (Hz) samples will be generated at. This is the configured
+    // rate, limited to maxSampleRate.
+    unsigned int getSampleRate() const;
+};
+
+#endif // not defined SYNTHETICTRACKERCOLLECTOR_H
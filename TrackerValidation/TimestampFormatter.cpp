@@ -0,0 +1,96 @@
+// Fast timestamp formatting for output rows.
+
+#include "TimestampFormatter.h"
+
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    // write value as exactly width digits
+    void writeDigits(char *out, long long value, std::size_t width)
+    {
+        for (std::size_t i = width; i > 0; --i)
+        {
+            out[i - 1] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
+}
+
+TimestampFormatter::TimestampFormatter(Resolution resolution)
+    : resolution(resolution), haveCache(false), cachedSecond(0), prefixLength(0)
+{
+    prefix[0] = '\0';
+}
+
+std::size_t TimestampFormatter::format(std::chrono::system_clock::time_point timestamp,
+                                       char *out)
+{
+    // split into whole seconds and microseconds, rounding down so times
+    // before the epoch still have a positive fraction
+    const long long us = std::chrono::duration_cast<std::chrono::microseconds>(
+        timestamp.time_since_epoch()).count();
+    long long seconds = us / 1000000;
+    long long fraction = us % 1000000;
+    if (fraction < 0)
+    {
+        fraction += 1000000;
+        --seconds;
+    }
+
+    const std::time_t second = static_cast<std::time_t>(seconds);
+    if (!haveCache || second != cachedSecond)
+    {
+        struct tm buffer;
+#ifdef _WIN32
+        const bool ok = (localtime_s(&buffer, &second) == 0);
+#else
+        const bool ok = (localtime_r(&second, &buffer) != nullptr);
+#endif
+        if (!ok)
+        {
+            throw std::runtime_error("Could not convert timestamp to local time");
+        }
+
+        prefixLength = std::strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &buffer);
+        cachedSecond = second;
+        haveCache = true;
+    }
+
+    std::memcpy(out, prefix, prefixLength);
+    std::size_t length = prefixLength;
+    out[length++] = '.';
+    if (resolution == Resolution::Milliseconds)
+    {
+        writeDigits(out + length, fraction / 1000, 3);
+        length += 3;
+    }
+    else
+    {
+        writeDigits(out + length, fraction, 6);
+        length += 6;
+    }
+    out[length] = '\0';
+
+    return length;
+}
+
+std::string TimestampFormatter::format(std::chrono::system_clock::time_point timestamp)
+{
+    char buffer[maxLength];
+    return std::string(buffer, format(timestamp, buffer));
+}
+
+std::size_t TimestampFormatter::formatEpochNs(std::chrono::system_clock::time_point timestamp,
+                                              char *out)
+{
+    const long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        timestamp.time_since_epoch()).count();
+
+    // a long long always fits
+    const std::to_chars_result result = std::to_chars(out, out + maxLength - 1, ns);
+    *result.ptr = '\0';
+    return static_cast<std::size_t>(result.ptr - out);
+}
@@ -0,0 +1,52 @@
+// Fast timestamp formatting for output rows.
+// Converting to local time (and formatting it through iostreams) is slow, and
+// only has to be done once a second. The date and time are cached, and only
+// the fraction of a second is formatted for each timestamp, with plain
+// integer arithmetic.
+
+#ifndef TIMESTAMPFORMATTER_H
+#define TIMESTAMPFORMATTER_H
+
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <string>
+
+class TimestampFormatter
+{
+  public:
+    enum class Resolution
+    {
+        Milliseconds,
+        Microseconds
+    };
+
+    // longest string either format method writes, with the terminating null
+    static constexpr std::size_t maxLength = 32;
+
+  private:
+    Resolution resolution;
+
+    // "YYYY-MM-DD HH:MM:SS" for cachedSecond
+    bool haveCache;
+    std::time_t cachedSecond;
+    char prefix[maxLength];
+    std::size_t prefixLength;
+
+  public:
+    explicit TimestampFormatter(Resolution resolution = Resolution::Microseconds);
+
+    // Write the local time, as "YYYY-MM-DD HH:MM:SS.mmm" or
+    // "YYYY-MM-DD HH:MM:SS.uuuuuu", to out (at least maxLength chars).
+    // This isn't thread safe - use one formatter per thread.
+    // @returns the length written, not including the terminating null
+    std::size_t format(std::chrono::system_clock::time_point timestamp, char *out);
+    std::string format(std::chrono::system_clock::time_point timestamp);
+
+    // Write the nanoseconds since the epoch to out (at least maxLength chars).
+    // @returns the length written, not including the terminating null
+    static std::size_t formatEpochNs(std::chrono::system_clock::time_point timestamp,
+                                     char *out);
+};
+
+#endif // not defined TIMESTAMPFORMATTER_H
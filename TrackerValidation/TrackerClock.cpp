@@ -0,0 +1,157 @@
+// Maps tracker timestamps onto the host's steady clock.
+
+#include "TrackerClock.h"
+
+#include <stdexcept>
+
+namespace
+{
+    // a pair further than this from the estimate means the tracker clock has
+    // jumped rather than drifted (seconds)
+    const double maxJump = 1.0;
+
+    // we need at least this much tracker time before we trust the drift
+    const double minSpan = 2.0;
+}
+
+TrackerClock::TrackerClock(double ticksPerSecond, double window,
+                           double interval)
+    : ticksPerSecond(ticksPerSecond), bucketLength(interval),
+      maxBuckets(0), trackerOrigin(0.0)
+{
+    if (ticksPerSecond <= 0.0 || interval <= 0.0 || window < interval)
+    {
+        throw std::runtime_error("Invalid tracker clock settings");
+    }
+
+    maxBuckets = static_cast<std::size_t>(window / interval);
+    reset();
+}
+
+void TrackerClock::reset()
+{
+    buckets.clear();
+    haveCurrent = false;
+    currentStart = 0.0;
+    latest = 0.0;
+    drift = 1.0;
+    offset = 0.0;
+}
+
+void TrackerClock::refit()
+{
+    // include the interval being filled, so we have something to go on
+    // before the first one is complete
+    double n = 0.0, sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    auto add = [&](const std::pair<double, double> &p) {
+        n += 1.0;
+        sumX += p.first;
+        sumY += p.second;
+        sumXX += p.first * p.first;
+        sumXY += p.first * p.second;
+    };
+    for (const std::pair<double, double> &p : buckets)
+    {
+        add(p);
+    }
+    add(current);
+
+    double denom = n * sumXX - sumX * sumX;
+    if (getSpan() >= minSpan && denom > 0.0)
+    {
+        drift = (n * sumXY - sumX * sumY) / denom;
+    }
+
+    // lower envelope
+    offset = current.second - drift * current.first;
+    for (const std::pair<double, double> &p : buckets)
+    {
+        double o = p.second - drift * p.first;
+        if (o < offset)
+        {
+            offset = o;
+        }
+    }
+}
+
+std::chrono::steady_clock::time_point TrackerClock::update(
+    double trackerTime, std::chrono::steady_clock::time_point arrival)
+{
+    if (!haveCurrent)
+    {
+        trackerOrigin = trackerTime;
+        hostOrigin = arrival;
+    }
+
+    double x = (trackerTime - trackerOrigin) / ticksPerSecond;
+    double y = std::chrono::duration<double>(arrival - hostOrigin).count();
+
+    // start again if the tracker clock went backwards or jumped
+    if (haveCurrent)
+    {
+        double predicted = offset + drift * x;
+        if (x < latest || y - predicted > maxJump || predicted - y > maxJump)
+        {
+            reset();
+            return update(trackerTime, arrival);
+        }
+    }
+    latest = x;
+
+    if (!haveCurrent)
+    {
+        haveCurrent = true;
+        current = std::make_pair(x, y);
+        currentStart = x;
+        refit();
+    }
+    else if (x - currentStart >= bucketLength)
+    {
+        // interval complete - this pair starts the next one
+        buckets.push_back(current);
+        if (buckets.size() > maxBuckets)
+        {
+            buckets.pop_front();
+        }
+
+        current = std::make_pair(x, y);
+        currentStart = x;
+        refit();
+    }
+    else if (y - x < current.second - current.first)
+    {
+        // quicker than anything else in this interval (the drift over one
+        // interval is far too small to matter here)
+        current = std::make_pair(x, y);
+        refit();
+    }
+
+    return toHost(trackerTime);
+}
+
+std::chrono::steady_clock::time_point TrackerClock::toHost(double trackerTime) const
+{
+    if (!haveCurrent)
+    {
+        return std::chrono::steady_clock::time_point();
+    }
+
+    double x = (trackerTime - trackerOrigin) / ticksPerSecond;
+    return hostOrigin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(offset + drift * x));
+}
+
+double TrackerClock::getDriftPpm() const
+{
+    return (drift - 1.0) * 1e6;
+}
+
+double TrackerClock::getSpan() const
+{
+    if (!haveCurrent)
+    {
+        return 0.0;
+    }
+
+    return latest - (buckets.empty() ? currentStart : buckets.front().first);
+}
@@ -0,0 +1,79 @@
+// Maps tracker timestamps onto the host's steady clock.
+// Trackers stamp samples with their own clock, which has an unknown offset
+// from ours and runs at a slightly different rate. Every sample gives us a
+// (tracker time, host arrival time) pair. Transport delays can only ever make
+// samples late, so the quickest pair in each short interval is kept, a least
+// squares fit over those minima for the last minute or so estimates the
+// drift, and the offset is taken from the quickest pair of all (the lower
+// envelope). The estimate is updated with every sample.
+
+#ifndef TRACKERCLOCK_H
+#define TRACKERCLOCK_H
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <utility> // for std::pair
+
+class TrackerClock
+{
+  private:
+    double ticksPerSecond;
+
+    // length of each interval, and how many intervals are fitted
+    double bucketLength;
+    std::size_t maxBuckets;
+
+    // origins, so the fit is done on small numbers
+    double trackerOrigin;
+    std::chrono::steady_clock::time_point hostOrigin;
+
+    // quickest (tracker seconds, host seconds) pair of each interval, from
+    // the origins, oldest first
+    std::deque<std::pair<double, double> > buckets;
+
+    // the interval being filled
+    bool haveCurrent;
+    std::pair<double, double> current;
+    double currentStart;
+
+    // newest tracker time seen (seconds from the origin)
+    double latest;
+
+    // host = offset + drift * tracker (in seconds from the origins)
+    double drift;
+    double offset;
+
+    // recalculate drift and offset from the intervals
+    void refit();
+
+  public:
+    // @param ticksPerSecond tracker clock units per second (e.g. 1000 for ms)
+    // @param window seconds of tracker time to fit the drift over
+    // @param interval seconds of tracker time each quickest pair is chosen from
+    explicit TrackerClock(double ticksPerSecond, double window = 60.0,
+                          double interval = 0.1);
+
+    // Add a tracker timestamp and the (host) time it arrived, and update the
+    // estimate. If the tracker clock goes backwards or jumps (e.g. it was
+    // restarted) the estimate starts again.
+    // @returns the estimated host time of trackerTime
+    std::chrono::steady_clock::time_point update(
+        double trackerTime, std::chrono::steady_clock::time_point arrival);
+
+    // Estimated host time of a tracker timestamp. If there have been no
+    // updates yet, this returns a default constructed time_point.
+    std::chrono::steady_clock::time_point toHost(double trackerTime) const;
+
+    // Difference in clock rates, in parts per million (positive if the
+    // tracker clock runs slow).
+    double getDriftPpm() const;
+
+    // Seconds of tracker time the estimate is based on.
+    double getSpan() const;
+
+    // Forget everything.
+    void reset();
+};
+
+#endif // not defined TRACKERCLOCK_H
@@ -10,6 +10,13 @@ std::ostream &operator<<(std::ostream &str,
                          const TrackerConfig &config)
 {
     str << "{ ipAddress=" << config.ipAddress
-        << ", port=" << config.ipPort << " }";
+        << ", port=" << config.ipPort
+        << ", sampleRate=" << config.sampleRate;
+    if (!config.replayFile.empty())
+    {
+        str << ", replayFile=" << config.replayFile
+            << ", replaySpeed=" << config.replaySpeed;
+    }
+    str << " }";
     return str;
 }
\ No newline at end of file
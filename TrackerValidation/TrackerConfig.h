@@ -5,6 +5,8 @@
 #ifndef TRACKERCONFIG_H
 #define TRACKERCONFIG_H
 
+#include "SyntheticGazeGenerator.h"
+
 #include <iosfwd>
 #include <string>
 
@@ -14,8 +16,22 @@ class TrackerConfig
     std::string ipAddress;
     unsigned int ipPort;
 
-    TrackerConfig(std::string ip, unsigned int port)
-        : ipAddress(ip), ipPort(port)
+    // Requested sample rate in Hz, for trackers which poll for their data.
+    // 0 means use the tracker default.
+    unsigned int sampleRate;
+
+    // Gaze recording to play back (replay tracker only), and how fast to play
+    // it: 1.0 is the original speed, 2.0 twice as fast, etc. 0 means as fast
+    // as possible.
+    std::string replayFile;
+    double replaySpeed;
+
+    // Error model for the generated gaze (synthetic tracker only)
+    SyntheticGazeModel synthetic;
+
+    TrackerConfig(std::string ip, unsigned int port, unsigned int rate = 0)
+        : ipAddress(ip), ipPort(port), sampleRate(rate), replaySpeed(1.0),
+          synthetic()
     {}
 
     friend std::ostream &operator<<(std::ostream &str,
@@ -7,12 +7,15 @@
 #include "DummyTrackerCollector.h"
 #include "Eyelink1000PlusCollector.h"
 #include "GazepointGP3Collector.h"
+#include "ReplayTrackerCollector.h"
+#include "SyntheticTrackerCollector.h"
 
 #include <stdexcept>
 
 TrackerDataCollector::TrackerDataCollector(ScreenPositionStore &store,
                                            const TrackerConfig &config)
-    : position(store), processRunning(false), config(config)
+    : position(store), processRunning(false), config(config),
+      targetPosition(nullptr)
 { }
 
 bool TrackerDataCollector::isRunning() const
@@ -20,6 +23,11 @@ bool TrackerDataCollector::isRunning() const
     return processRunning;
 }
 
+void TrackerDataCollector::setTargetStore(const ScreenPositionStore *store)
+{
+    targetPosition = store;
+}
+
 TrackerDataCollector *TrackerDataCollector::create(
     const std::string &tracker,
     ScreenPositionStore &store,
@@ -37,6 +45,14 @@ TrackerDataCollector *TrackerDataCollector::create(
     {
         return new GazepointGP3Collector(store, config);
     }
+    else if (tracker == "replay")
+    {
+        return new ReplayTrackerCollector(store, config);
+    }
+    else if (tracker == "synthetic")
+    {
+        return new SyntheticTrackerCollector(store, config, config.synthetic);
+    }
     else
     {
         std::string err("Unknown tracker: \"" + tracker + "\"");
@@ -25,11 +25,16 @@ class TrackerDataCollector
     // is the data collector process running?
     bool processRunning;
 
+    // position of the target being shown, if known (may be nullptr)
+    const ScreenPositionStore *targetPosition;
+
     // constructor hidden as this is using a factory pattern
     TrackerDataCollector(ScreenPositionStore& store,
                          const TrackerConfig &config);
 
   public:
+    virtual ~TrackerDataCollector() {}
+
     // create a data collector of the type defined in tracker.
     // throws std::runtime_error if tracker does not match any known type.
     static TrackerDataCollector *create(const std::string &tracker,
@@ -49,6 +54,10 @@ class TrackerDataCollector
 
     // Is the data collector process running?
     bool isRunning() const;
+
+    // Tell the collector where the targets are being shown. Only simulated
+    // trackers use this; real trackers ignore it. Set this before run().
+    void setTargetStore(const ScreenPositionStore *store);
 };
 
 #endif // defined TRACKERDATACOLLECTOR_H
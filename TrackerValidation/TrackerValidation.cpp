@@ -3,9 +3,10 @@
 
 #include "Validator.h"
 
-#include "common.h"
+#include "DisplayGeometry.h"
 #include "TrackerConfig.h"
 #include "ValidatorConfig.h"
+#include "ValidatorUIHeadless.h"
 #include "version.h"
 
 #include <iostream>
@@ -36,6 +37,8 @@ void printUsage(const char * const cmd)
     std::cout << "Usage: " << cmd << " [options]" << std::endl
               << flag << "help\t\t\tdisplay this help text" << std::endl
               << flag << "preview\t\tdisplay all target locations on screen" << std::endl
+              << flag << "headless\t\trun without a display, clicking the middle of each target as soon as it is" << std::endl
+                    << "\t\t\t\tshown (for testing the whole system, e.g. with the \"synthetic\" tracker)" << std::endl
               << flag << "cols" << equals << "<n>"
                     << "\t\tsplit screen into <n> columns (default "
                     << config.cols << ")" << std::endl
@@ -45,6 +48,13 @@ void printUsage(const char * const cmd)
               << flag << "repeats" << equals << "<n>"
                     << "\t\tnumber of times to test each point (default "
                     << config.repeats << ")" << std::endl
+              << flag << "stopwidth" << equals << "<n>"
+                    << "\t\tstop testing a point once its 95% accuracy confidence interval is this wide" << std::endl
+                    << "\t\t\t\t(degrees, or pixels without screen size), with repeats as the maximum. 0 to always" << std::endl
+                    << "\t\t\t\tdo every repeat (default " << config.stopWidth << ")" << std::endl
+              << flag << "minrepeats" << equals << "<n>"
+                    << "\t\tfewest times to test each point when using stopwidth (default "
+                    << config.minRepeats << ")" << std::endl
               << flag << "padding" << equals << "<n>"
                     << "\t\tmargin in pixels from screen edges which will be excluded in target location calculations" << std::endl
                     << "\t\t\t\t(default " << config.padding << ")" << std::endl
@@ -63,13 +73,65 @@ void printUsage(const char * const cmd)
               << flag << "outputfile" << equals << "<s>"
                     << "\t\tpath to file to write output data to, or leave empty to write to console" << std::endl
                     << "\t\t\t\t(default \"" << config.outputFile << "\")" << std::endl
+              << flag << "outputsync" << equals << "<n>"
+                    << "\t\tforce the output file to disk after every batch of rows (0), at most every <n> ms," << std::endl
+                    << "\t\t\t\tor leave it to the OS (-1) (default " << config.outputSync << ")" << std::endl
               << flag << "tracker" << equals << "<s>"
-                    << "\t\tthe tracker being tested (\"mouse\", \"eyelink\" or \"GP3\")" << std::endl
+                    << "\t\tthe tracker being tested (\"mouse\", \"eyelink\", \"GP3\", \"synthetic\" or \"replay\")" << std::endl
                     << "\t\t\t\t(default \"" << config.tracker << "\")" << std::endl
               << flag << "trackerip" << equals << "<s>"
                     << "\t\tIP address used by the tracker (tracker default if not set)" << std::endl
               << flag << "trackerport" << equals << "<n>"
                     << "\tIP port used by the tracker (tracker default if not set)" << std::endl
+              << flag << "trackerrate" << equals << "<n>"
+                    << "\tsample rate in Hz for \"mouse\" and \"synthetic\" trackers (tracker default if not set)" << std::endl
+              << flag << "measurewindow" << equals << "<n>"
+                    << "\tms of gaze before each measurement to summarise (default "
+                    << config.measureWindow << ")" << std::endl
+              << flag << "dwell" << equals << "<n>"
+                    << "\t\tmeasure automatically once the gaze is on the target for <n> ms, or 0 to only" << std::endl
+                    << "\t\t\t\tmeasure on a click (default " << config.dwellTime << ")" << std::endl
+              << flag << "dwellradius" << equals << "<n>"
+                    << "\tpixels from the target centre counted as on target for dwell (default "
+                    << config.dwellRadius << ")" << std::endl
+              << flag << "minreaction" << equals << "<n>"
+                    << "\tignore measurements made less than <n> ms after the target appeared, as" << std::endl
+                    << "\t\t\t\tanticipatory, or 0 to keep them all (default " << config.minReactionTime << ")" << std::endl
+              << flag << "fixationmethod" << equals << "<s>"
+                    << "\tfixation detection, by velocity or dispersion (\"ivt\" or \"idt\")" << std::endl
+                    << "\t\t\t\t(default \"" << config.fixationMethod << "\")" << std::endl
+              << flag << "fixationthreshold" << equals << "<n>"
+                    << "\tfixation threshold in pixels/s (ivt) or pixels (idt), or 0 for the default" << std::endl
+                    << "\t\t\t\t(default " << config.fixationThreshold << ")" << std::endl
+              << flag << "screenwidth" << equals << "<n>"
+                    << "\twidth of the display area in mm, for results in degrees of visual angle" << std::endl
+              << flag << "screenheight" << equals << "<n>"
+                    << "\theight of the display area in mm" << std::endl
+              << flag << "distance" << equals << "<n>"
+                    << "\t\tdistance from the eye to the screen in mm" << std::endl
+              << flag << "recordfile" << equals << "<s>"
+                    << "\t\tpath to write every raw gaze sample and the target shown to, or leave empty to not record (default \""
+                    << config.recordFile << "\")" << std::endl
+              << flag << "replayfile" << equals << "<s>"
+                    << "\t\tgaze recording to play back with the \"replay\" tracker" << std::endl
+              << flag << "replayspeed" << equals << "<n>"
+                    << "\tplayback speed, e.g. 2 for twice as fast, or 0 for as fast as possible (default "
+                    << config.trackerConfig.replaySpeed << ")" << std::endl
+              << flag << "synthnoise" << equals << "<n>"
+                    << "\t\twhite noise SD in pixels for the \"synthetic\" tracker, both eyes (default "
+                    << config.trackerConfig.synthetic.right.whiteNoise << ")" << std::endl
+              << flag << "synthpink" << equals << "<n>"
+                    << "\t\tpink (1/f) noise SD in pixels for the \"synthetic\" tracker, both eyes (default "
+                    << config.trackerConfig.synthetic.right.pinkNoise << ")" << std::endl
+              << flag << "synthblinks" << equals << "<n>"
+                    << "\tblinks per minute for the \"synthetic\" tracker (default "
+                    << config.trackerConfig.synthetic.blinkRate << ")" << std::endl
+              << flag << "synthdropout" << equals << "<n>"
+                    << "\tprobability of each sample being lost, per eye, for the \"synthetic\" tracker (default "
+                    << config.trackerConfig.synthetic.right.dropoutRate << ")" << std::endl
+              << flag << "synthseed" << equals << "<n>"
+                    << "\t\trandom seed for the \"synthetic\" tracker (default "
+                    << config.trackerConfig.synthetic.seed << ")" << std::endl
               << flag << "subject" << equals << "<s>"
                     << "\t\tname or ID of the subject under test, or \"\" for a prompt (default \""
                     << config.subject << "\")" << std::endl;
@@ -92,14 +154,17 @@ int main(int argc, char *argv[])
 
 #ifndef _WIN32
     // grab the config from the command line
-    static const char * const cmdShort = "c:hl:r:n:t:g:c:s:i:p:o:u:";
+    static const char * const cmdShort = "c:hl:r:n:t:g:c:s:i:p:f:o:u:";
     static const struct option cmdOpts[] = {
         {"help",        no_argument,       nullptr, 'h'},
         {"preview",     no_argument,       nullptr, 'x'},
+        {"headless",    no_argument,       nullptr, 'F'},
         {"cols",        required_argument, nullptr, 'c'},
         {"rows",        required_argument, nullptr, 'r'},
         {"repeats",     required_argument, nullptr, 'n'},
         {"padding",     required_argument, nullptr, 'm'},
+        {"stopwidth",   required_argument, nullptr, 'q'},
+        {"minrepeats",  required_argument, nullptr, 'A'},
         {"targsize",    required_argument, nullptr, 't'},
         {"targtype",    required_argument, nullptr, 'g'},
         {"targlocation",required_argument, nullptr, 'z'},
@@ -107,7 +172,26 @@ int main(int argc, char *argv[])
         {"tracker",     required_argument, nullptr, 's'},
         {"trackerip",   required_argument, nullptr, 'i'},
         {"trackerport", required_argument, nullptr, 'p'},
+        {"trackerrate", required_argument, nullptr, 'f'},
         {"outputfile",  required_argument, nullptr, 'o'},
+        {"outputsync",  required_argument, nullptr, 'D'},
+        {"measurewindow", required_argument, nullptr, 'a'},
+        {"dwell",       required_argument, nullptr, 'B'},
+        {"dwellradius", required_argument, nullptr, 'C'},
+        {"minreaction", required_argument, nullptr, 'E'},
+        {"fixationmethod", required_argument, nullptr, 'd'},
+        {"fixationthreshold", required_argument, nullptr, 'j'},
+        {"screenwidth", required_argument, nullptr, 'e'},
+        {"screenheight",required_argument, nullptr, 'k'},
+        {"distance",    required_argument, nullptr, 'b'},
+        {"recordfile",  required_argument, nullptr, 'w'},
+        {"replayfile",  required_argument, nullptr, 'y'},
+        {"replayspeed", required_argument, nullptr, 'v'},
+        {"synthnoise",  required_argument, nullptr, 'N'},
+        {"synthpink",   required_argument, nullptr, 'P'},
+        {"synthblinks", required_argument, nullptr, 'K'},
+        {"synthdropout",required_argument, nullptr, 'O'},
+        {"synthseed",   required_argument, nullptr, 'S'},
         {"subject",     required_argument, nullptr, 'u'},
         {nullptr,    no_argument,       nullptr, 0}
     };
@@ -193,6 +277,34 @@ int main(int argc, char *argv[])
         {
             config.repeats = std::atoi(val.c_str());
         }
+        else if (key == "stopwidth")
+        {
+            double width = std::atof(val.c_str());
+            if (width < 0.0)
+            {
+                std::cerr << "ERROR: stopwidth value must not be negative"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else
+            {
+                config.stopWidth = width;
+            }
+        }
+        else if (key == "minrepeats")
+        {
+            int intval = std::atoi(val.c_str());
+            if (intval < 2)
+            {
+                std::cerr << "ERROR: minrepeats value must be at least 2"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else
+            {
+                config.minRepeats = static_cast<unsigned int>(intval);
+            }
+        }
         else if (key == "padding")
         {
             int intval = std::atoi(val.c_str());
@@ -236,6 +348,191 @@ int main(int argc, char *argv[])
         {
             config.outputFile = val;
         }
+        else if (key == "outputsync")
+        {
+            int intval = std::atoi(val.c_str());
+            if (intval < -1)
+            {
+                std::cerr << "ERROR: outputsync value must be -1 or more"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else
+            {
+                config.outputSync = intval;
+            }
+        }
+        else if (key == "measurewindow")
+        {
+            int intval = std::atoi(val.c_str());
+            if (intval <= 0)
+            {
+                std::cerr << "ERROR: measurewindow value must be positive"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else
+            {
+                config.measureWindow = static_cast<unsigned int>(intval);
+            }
+        }
+        else if (key == "dwell")
+        {
+            int intval = std::atoi(val.c_str());
+            if (intval < 0)
+            {
+                std::cerr << "ERROR: dwell value must not be negative"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else
+            {
+                config.dwellTime = static_cast<unsigned int>(intval);
+            }
+        }
+        else if (key == "dwellradius")
+        {
+            double radius = std::atof(val.c_str());
+            if (radius <= 0.0)
+            {
+                std::cerr << "ERROR: dwellradius value must be positive"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else
+            {
+                config.dwellRadius = radius;
+            }
+        }
+        else if (key == "minreaction")
+        {
+            double ms = std::atof(val.c_str());
+            if (ms < 0.0)
+            {
+                std::cerr << "ERROR: minreaction value must not be negative"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else
+            {
+                config.minReactionTime = ms;
+            }
+        }
+        else if (key == "fixationmethod")
+        {
+            if (val == "ivt" || val == "idt")
+            {
+                config.fixationMethod = val;
+            }
+            else
+            {
+                std::cerr << "ERROR: fixationmethod must be either \"ivt\" "
+                          << "or \"idt\"" << std::endl;
+                configSuccess = false;
+            }
+        }
+        else if (key == "fixationthreshold")
+        {
+            double threshold = std::atof(val.c_str());
+            if (threshold < 0.0)
+            {
+                std::cerr << "ERROR: fixationthreshold value must not be negative"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else
+            {
+                config.fixationThreshold = threshold;
+            }
+        }
+        else if (key == "screenwidth" || key == "screenheight" || key == "distance")
+        {
+            double mm = std::atof(val.c_str());
+            if (mm <= 0.0)
+            {
+                std::cerr << "ERROR: " << key << " value must be positive"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else if (key == "screenwidth")
+            {
+                config.screenWidth = mm;
+            }
+            else if (key == "screenheight")
+            {
+                config.screenHeight = mm;
+            }
+            else
+            {
+                config.viewingDistance = mm;
+            }
+        }
+        else if (key == "recordfile")
+        {
+            config.recordFile = val;
+        }
+        else if (key == "replayfile")
+        {
+            config.trackerConfig.replayFile = val;
+        }
+        else if (key == "replayspeed")
+        {
+            double speed = std::atof(val.c_str());
+            if (speed < 0.0)
+            {
+                std::cerr << "ERROR: replayspeed value must not be negative"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else
+            {
+                config.trackerConfig.replaySpeed = speed;
+            }
+        }
+        else if (key == "synthnoise" || key == "synthpink" ||
+                 key == "synthblinks")
+        {
+            double value = std::atof(val.c_str());
+            SyntheticGazeModel &model = config.trackerConfig.synthetic;
+            if (value < 0.0)
+            {
+                std::cerr << "ERROR: " << key << " value must not be negative"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else if (key == "synthnoise")
+            {
+                model.right.whiteNoise = model.left.whiteNoise = value;
+            }
+            else if (key == "synthpink")
+            {
+                model.right.pinkNoise = model.left.pinkNoise = value;
+            }
+            else
+            {
+                model.blinkRate = value;
+            }
+        }
+        else if (key == "synthdropout")
+        {
+            double rate = std::atof(val.c_str());
+            if (rate < 0.0 || rate > 1.0)
+            {
+                std::cerr << "ERROR: synthdropout value must be between 0 and 1"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else
+            {
+                SyntheticGazeModel &model = config.trackerConfig.synthetic;
+                model.right.dropoutRate = model.left.dropoutRate = rate;
+            }
+        }
+        else if (key == "synthseed")
+        {
+            config.trackerConfig.synthetic.seed =
+                static_cast<std::uint32_t>(std::strtoul(val.c_str(), nullptr, 10));
+        }
         else if (key == "system" || key == "tracker")
         {
             config.tracker = val;
@@ -261,6 +558,20 @@ int main(int argc, char *argv[])
             config.trackerConfig.ipPort = std::atoi(val.c_str());
             trackerIPPortConfigured = true;
         }
+        else if (key == "trackerrate")
+        {
+            int intval = std::atoi(val.c_str());
+            if (intval <= 0)
+            {
+                std::cerr << "ERROR: trackerrate value must be positive"
+                          << std::endl;
+                configSuccess = false;
+            }
+            else
+            {
+                config.trackerConfig.sampleRate = static_cast<unsigned int>(intval);
+            }
+        }
         else if (key == "help")
         {
             // this will trigger the help message to be shown
@@ -270,6 +581,10 @@ int main(int argc, char *argv[])
         {
             config.preview = true;
         }
+        else if (key == "headless")
+        {
+            config.headless = true;
+        }
         else
         {
             std::cerr << "Error: Invalid argument: " << key << std::endl;
@@ -296,13 +611,52 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (config.stopWidth > 0.0 && config.minRepeats > config.repeats)
+    {
+        std::cerr << "ERROR: minrepeats must not be more than repeats"
+                  << std::endl;
+        configSuccess = false;
+    }
+
+    // visual angles need all of the screen geometry
+    const int geometryCount = (config.screenWidth > 0.0 ? 1 : 0)
+                            + (config.screenHeight > 0.0 ? 1 : 0)
+                            + (config.viewingDistance > 0.0 ? 1 : 0);
+    if (geometryCount != 0 && geometryCount != 3)
+    {
+        std::cerr << "ERROR: screenwidth, screenheight and distance must all "
+                  << "be given for visual angles" << std::endl;
+        configSuccess = false;
+    }
+
+    // nothing is clicked in preview mode, so a headless preview never ends
+    if (config.headless && config.preview)
+    {
+        std::cerr << "ERROR: preview can't be used with headless" << std::endl;
+        configSuccess = false;
+    }
+
+    // headless clicks come straight after the target is drawn, so would all
+    // be anticipatory
+    if (config.headless && config.minReactionTime > 0.0)
+    {
+        std::cerr << "ERROR: minreaction can't be used with headless" << std::endl;
+        configSuccess = false;
+    }
+
     if (!configSuccess)
     {
         printUsage(argv[0]);
         return EXIT_FAILURE;
     }
 
-    std::pair<unsigned int, unsigned int> screenRes = common::getScreenRes();
+    // without a display, pretend to have a typical one
+    if (config.headless)
+    {
+        DisplayGeometry::get().setResolution(ValidatorUIHeadless::defaultResolution);
+    }
+
+    std::pair<unsigned int, unsigned int> screenRes = DisplayGeometry::get().getResolution();
     std::cout << "Screen resolution: " << screenRes.first << "x"
               << screenRes.second << std::endl;
 
@@ -323,8 +677,12 @@ int main(int argc, char *argv[])
         std::cerr << "Error: " << e.what() << std::endl;
         return EXIT_FAILURE;
     }
-    std::cout << "Finished! Press ENTER to exit" << std::endl;
-    std::cin.get();
+    // there's nobody to press ENTER when headless
+    if (!config.headless)
+    {
+        std::cout << "Finished! Press ENTER to exit" << std::endl;
+        std::cin.get();
+    }
     std::cout << "Have a nice day :)" << std::endl;
 
     return EXIT_SUCCESS;
@@ -0,0 +1,209 @@
+// Accuracy and precision statistics, kept up to date as measurements are
+// made.
+
+#include "ValidationStats.h"
+
+#include <algorithm> // for std::max
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+RunningStats::RunningStats()
+    : count(0), mean(0.0), m2(0.0)
+{ }
+
+void RunningStats::add(double value)
+{
+    ++count;
+    const double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+}
+
+std::size_t RunningStats::getCount() const
+{
+    return count;
+}
+
+double RunningStats::getMean() const
+{
+    return mean;
+}
+
+double RunningStats::getVariance() const
+{
+    return (count > 1 ? m2 / (count - 1) : 0.0);
+}
+
+double RunningStats::getSD() const
+{
+    return std::sqrt(getVariance());
+}
+
+double RunningStats::getConfidenceWidth() const
+{
+    // two sided 97.5% quantiles of the t distribution, for 1 to 30 degrees
+    // of freedom. Beyond that the normal distribution is close enough.
+    static const double t975[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    static const std::size_t tableSize = sizeof(t975) / sizeof(t975[0]);
+
+    if (count < 2)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    const std::size_t df = count - 1;
+    const double t = (df <= tableSize ? t975[df - 1] : 1.96);
+    return 2.0 * t * getSD() / std::sqrt(static_cast<double>(count));
+}
+
+double EyeTargetStats::getRmsS2S() const
+{
+    return std::sqrt(rmsS2SSquared.getMean());
+}
+
+namespace
+{
+    void writeRow(std::ostream &str, const std::string &target,
+                  const char *eye, const EyeTargetStats &stats)
+    {
+        str << target << ",\"" << eye << "\","
+            << stats.accuracy.getCount() << ","
+            << stats.offsetX.getMean() << "," << stats.offsetY.getMean() << ","
+            << stats.offsetX.getSD() << "," << stats.offsetY.getSD() << ","
+            << stats.accuracy.getMean() << "," << stats.accuracy.getSD() << ","
+            << stats.getRmsS2S() << std::endl;
+    }
+}
+
+ValidationStats::ValidationStats(std::size_t targetCount,
+                                 const VisualAngleConverter *converter)
+    : targets(targetCount * 2), converter(converter)
+{ }
+
+void ValidationStats::addEye(unsigned int targetNumber, EyeTargetStats &target,
+                             EyeTargetStats &overall, double xTarget,
+                             double yTarget, const EyeWindowStats &eye)
+{
+    if (eye.count == 0)
+    {
+        return;
+    }
+
+    double dx = eye.meanX - xTarget;
+    double dy = eye.meanY - yTarget;
+    double s2s = eye.rmsS2S;
+    if (converter != nullptr)
+    {
+        converter->toDegrees(targetNumber, dx, dy, dx, dy);
+        s2s = converter->distanceToDegrees(targetNumber, s2s);
+    }
+    const double error = std::sqrt(dx * dx + dy * dy);
+
+    for (EyeTargetStats *stats : { &target, &overall })
+    {
+        stats->offsetX.add(dx);
+        stats->offsetY.add(dy);
+        stats->accuracy.add(error);
+        stats->rmsS2SSquared.add(s2s * s2s);
+    }
+}
+
+void ValidationStats::add(unsigned int targetNumber,
+                          unsigned int xTarget, unsigned int yTarget,
+                          const GazeWindowStats &window)
+{
+    if (targetNumber >= getTargetCount())
+    {
+        throw std::out_of_range("Invalid target number");
+    }
+
+    addEye(targetNumber, targets[targetNumber * 2], overall[0],
+           xTarget, yTarget, window.right);
+    addEye(targetNumber, targets[targetNumber * 2 + 1], overall[1],
+           xTarget, yTarget, window.left);
+}
+
+std::size_t ValidationStats::getTargetCount() const
+{
+    return targets.size() / 2;
+}
+
+const EyeTargetStats &ValidationStats::getTarget(unsigned int targetNumber,
+                                                 bool right) const
+{
+    if (targetNumber >= getTargetCount())
+    {
+        throw std::out_of_range("Invalid target number");
+    }
+
+    return targets[targetNumber * 2 + (right ? 0 : 1)];
+}
+
+const EyeTargetStats &ValidationStats::getOverall(bool right) const
+{
+    return overall[right ? 0 : 1];
+}
+
+double ValidationStats::getAccuracyWidth(unsigned int targetNumber) const
+{
+    const RunningStats &right = getTarget(targetNumber, true).accuracy;
+    const RunningStats &left = getTarget(targetNumber, false).accuracy;
+
+    if (right.getCount() == 0 && left.getCount() == 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double width = 0.0;
+    for (const RunningStats *eye : { &right, &left })
+    {
+        if (eye->getCount() > 0)
+        {
+            width = std::max(width, eye->getConfidenceWidth());
+        }
+    }
+    return width;
+}
+
+const char *ValidationStats::getUnits() const
+{
+    return (converter != nullptr ? "degrees" : "pixels");
+}
+
+void ValidationStats::write(std::ostream &str) const
+{
+    const std::ios_base::fmtflags flags = str.flags();
+    const std::streamsize precision = str.precision();
+
+    str << "\"Target-ID\",\"Eye\",\"N\","
+        << "\"Offset-X\",\"Offset-Y\",\"Offset-SD-X\",\"Offset-SD-Y\","
+        << "\"Accuracy\",\"Accuracy-SD\",\"RMS-S2S\"" << std::endl
+        << std::fixed << std::setprecision(converter != nullptr ? 3 : 2);
+
+    for (unsigned int t = 0; t < getTargetCount(); ++t)
+    {
+        const std::string target = std::to_string(t);
+        if (getTarget(t, true).accuracy.getCount() > 0)
+        {
+            writeRow(str, target, "Right", getTarget(t, true));
+        }
+        if (getTarget(t, false).accuracy.getCount() > 0)
+        {
+            writeRow(str, target, "Left", getTarget(t, false));
+        }
+    }
+
+    writeRow(str, "\"All\"", "Right", overall[0]);
+    writeRow(str, "\"All\"", "Left", overall[1]);
+
+    str.flags(flags);
+    str.precision(precision);
+}
@@ -0,0 +1,110 @@
+// Accuracy and precision statistics, kept up to date as measurements are
+// made so a summary is available as soon as a session ends.
+// For each target (and overall) and each eye we keep:
+//   - the offset of the gaze from the target (mean and SD of x and y),
+//   - the accuracy (distance of the gaze from the target, mean and SD), and
+//   - the RMS sample to sample precision within each measurement window.
+// The gaze position used is the window mean (see GazeWindowStats). Values
+// are in degrees of visual angle if a VisualAngleConverter is given, or
+// pixels if not.
+
+#ifndef VALIDATIONSTATS_H
+#define VALIDATIONSTATS_H
+
+#include "GazeWindowStats.h"
+#include "VisualAngle.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+// Running mean and variance (Welford's method).
+class RunningStats
+{
+  private:
+    std::size_t count;
+    double mean;
+    double m2; // sum of squared differences from the mean
+
+  public:
+    RunningStats();
+
+    void add(double value);
+
+    std::size_t getCount() const;
+
+    // these return zero if there are no values
+    double getMean() const;
+    double getVariance() const; // sample variance (n-1), zero for one value
+    double getSD() const;
+
+    // Full width of the 95% confidence interval of the mean (Student's t).
+    // This is infinite if there are fewer than two values.
+    double getConfidenceWidth() const;
+};
+
+struct EyeTargetStats
+{
+    RunningStats offsetX;
+    RunningStats offsetY;
+    RunningStats accuracy;
+
+    // squared RMS sample to sample precision of each measurement, so the
+    // combined RMS is sqrt of the mean
+    RunningStats rmsS2SSquared;
+
+    double getRmsS2S() const;
+};
+
+class ValidationStats
+{
+  private:
+    // right then left for each target
+    std::vector<EyeTargetStats> targets;
+
+    // right, left
+    EyeTargetStats overall[2];
+
+    // nullptr to keep everything in pixels
+    const VisualAngleConverter *converter;
+
+    void addEye(unsigned int targetNumber, EyeTargetStats &target,
+                EyeTargetStats &overall, double xTarget, double yTarget,
+                const EyeWindowStats &eye);
+
+  public:
+    // @param converter converts offsets from each target to degrees. It must
+    //        have every target set, and outlive this object.
+    explicit ValidationStats(std::size_t targetCount,
+                             const VisualAngleConverter *converter = nullptr);
+
+    // Add a measurement of the target at (xTarget, yTarget). Eyes with no
+    // valid samples in the window are ignored.
+    // @throws std::out_of_range if the target number is invalid
+    void add(unsigned int targetNumber,
+             unsigned int xTarget, unsigned int yTarget,
+             const GazeWindowStats &window);
+
+    std::size_t getTargetCount() const;
+
+    // @throws std::out_of_range if the target number is invalid
+    const EyeTargetStats &getTarget(unsigned int targetNumber, bool right) const;
+
+    const EyeTargetStats &getOverall(bool right) const;
+
+    // Width of the accuracy confidence interval of a target: the wider of
+    // the two eyes, ignoring an eye which has never had valid data. This is
+    // infinite if there aren't enough measurements to tell.
+    // @throws std::out_of_range if the target number is invalid
+    double getAccuracyWidth(unsigned int targetNumber) const;
+
+    // "degrees" or "pixels"
+    const char *getUnits() const;
+
+    // Write a summary table in CSV format, one row per target and eye, then
+    // the overall rows (Target-ID "All"). Targets with no measurements are
+    // skipped.
+    void write(std::ostream &str) const;
+};
+
+#endif // not defined VALIDATIONSTATS_H
@@ -4,24 +4,33 @@
 #include "Validator.h"
 
 #include "common.h"
+#include "DisplayGeometry.h"
 #include "ScreenPositionStore.h"
 #include "MeasuredData.h"
+#include "ValidatorUIHeadless.h"
 #include "ValidatorUIOpenGL.h"
 
+#include <algorithm> // for std::min
 #include <chrono>
 #include <cstdlib> // for rand()
 #include <ctime> // for time(), used to seed rand()
+#include <fstream>
 #include <iostream>
 #include <cmath>
 #include <sstream>
 #include <thread>
 
 Validator::Validator(const ValidatorConfig &conf)
-    : config(conf), ui(nullptr), data(nullptr),
-      showingTarget(false), targetIndex(0),
+    : showingTarget(false), data(nullptr),
+      validationStats(nullptr), summaryWritten(false),
+      visualAngle(nullptr),
+      dwellTrigger(nullptr),
       trackerDataCollector(nullptr),
-      gazePosThread(nullptr),
-      showGaze(true)
+      gazeRecorder(nullptr),
+      gazeSamplesShown(0), anticipatoryCount(0),
+      config(conf),
+      fixationTracker(nullptr),
+      targetIndex(0), ui(nullptr)
 {
     cursorPosition = new ScreenPositionStore();
     gazePosition = new ScreenPositionStore();
@@ -31,6 +40,17 @@ Validator::Validator(const ValidatorConfig &conf)
     trackerDataCollector = TrackerDataCollector::create(config.tracker,
                                                         *gazePosition,
                                                         config.trackerConfig);
+    trackerDataCollector->setTargetStore(targetPosition);
+
+    if (config.dwellTime > 0)
+    {
+        dwellTrigger = new DwellTrigger(config.dwellTime, config.dwellRadius);
+        gazePosition->setListener(dwellTrigger);
+    }
+
+    fixationTracker = new FixationTracker(*gazePosition,
+        FixationDetector(FixationDetector::methodFromName(config.fixationMethod),
+                         config.fixationThreshold));
 
     // initialise the test counts
     // if we're using "corners" target location, increase each dimension by 1
@@ -45,26 +65,43 @@ Validator::Validator(const ValidatorConfig &conf)
 
     testCount.resize(cols * rows, 0);
 
+    // work out the visual angle conversion for every target now, so it's
+    // cheap for each measurement
+    if (config.screenWidth > 0.0 && config.screenHeight > 0.0
+        && config.viewingDistance > 0.0)
+    {
+        std::pair<unsigned int, unsigned int> screenRes = DisplayGeometry::get().getResolution();
+        visualAngle = new VisualAngleConverter(ScreenGeometry{
+            screenRes.first, screenRes.second,
+            config.screenWidth, config.screenHeight, config.viewingDistance });
+
+        for (unsigned int index = 0; index < testCount.size(); ++index)
+        {
+            std::pair<unsigned int, unsigned int> pos = indexToTargetPos(index);
+            visualAngle->setTarget(index, pos.first, pos.second);
+        }
+    }
+    validationStats = new ValidationStats(testCount.size(), visualAngle);
+
     if (config.outputFile == "")
     {
-        data = MeasuredData::create("cout",
-                                    config.trackerLabel,
-                                    trackerDataCollector->getName(),
-                                    config.subject);
+        data = new MeasuredDataAsync(MeasuredData::create("cout",
+                                     config.trackerLabel,
+                                     trackerDataCollector->getName(),
+                                     config.subject));
     }
     else
     {
-        data = MeasuredData::create("file",
-                                    config.trackerLabel,
-                                    trackerDataCollector->getName(),
-                                    config.subject,
-                                    config.outputFile);
+        data = new MeasuredDataAsync(MeasuredData::create("file",
+                                     config.trackerLabel,
+                                     trackerDataCollector->getName(),
+                                     config.subject,
+                                     config.outputFile,
+                                     config.outputSync));
     }
 
     valPtr = this;
 
-    gazePosThread = new std::thread(&Validator::collectGazePos, this);
-
     // seed our random number generator, used to determine the order targets
     // are displayed
     srand(static_cast<unsigned int>(time(NULL)));
@@ -72,50 +109,50 @@ Validator::Validator(const ValidatorConfig &conf)
 
 Validator::~Validator()
 {
-    if (gazePosThread != nullptr)
-    {
-        showGaze = false;
-        gazePosThread->join();
-        delete gazePosThread;       gazePosThread = nullptr;
-    }
-
     valPtr = nullptr;
+
+    // stop the threads which use the stores (and the dwell listener) before
+    // deleting them. The collector goes first, so nothing new arrives.
+    trackerDataCollector->stop();
+    delete trackerDataCollector;    trackerDataCollector = nullptr;
+    delete fixationTracker;         fixationTracker = nullptr;
+    delete gazeRecorder;            gazeRecorder = nullptr;
+    gazePosition->setListener(nullptr);
+    delete dwellTrigger;            dwellTrigger = nullptr;
+
     delete data;                    data = nullptr;
+    delete validationStats;         validationStats = nullptr;
+    delete visualAngle;             visualAngle = nullptr;
     delete gazePosition;            gazePosition = nullptr;
     delete cursorPosition;          cursorPosition = nullptr;
     delete targetPosition;          targetPosition = nullptr;
     delete ui;                      ui = nullptr;
-    delete trackerDataCollector;    trackerDataCollector = nullptr;
 }
 
-void Validator::collectGazePos()
+void Validator::updateGazePos()
 {
-    while (showGaze)
+    // only update the UI if a sample has arrived since last time
+    const std::uint64_t received = gazePosition->getSampleBuffer().pushed();
+    if (received == gazeSamplesShown)
     {
-        if (ui != nullptr && gazePosition != nullptr)
-        {
-            std::pair<std::pair<unsigned int, unsigned int>, std::pair<unsigned int, unsigned int> >pos
-                = gazePosition->getCurrentPositionRightLeft();
-            ui->setGazePos(pos.first, pos.second);
-            refreshUI();
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return;
     }
+    gazeSamplesShown = received;
+
+    std::pair<std::pair<unsigned int, unsigned int>, std::pair<unsigned int, unsigned int> >pos
+        = gazePosition->getCurrentPositionRightLeft();
+    ui->setGazePos(pos.first, pos.second);
 }
 
-// idle function for the UI - processing done when UI drawing not
-// being processed.
+// timer function for the UI - the main processing, done on the UI thread
+// between drawing.
 Validator *Validator::valPtr = nullptr;
-void idleFunc(void)
+void timerFunc(void)
 {
     if (Validator::valPtr != nullptr)
     {
         Validator::valPtr->run();
     }
-    else
-    {
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-    }
 }
 
 void Validator::refreshUI()
@@ -134,31 +171,42 @@ void onClickFunc(int button, int state, int x, int y)
         throw std::runtime_error("onClickFunc called when thread not running!");
     }
 
-    // this should never happen
-    if (ValidatorUIOpenGL::getInstance() == nullptr)
-    {
-        throw std::runtime_error("onClickFunc called before UI was started!");
-    }
-
-    if (ValidatorUIOpenGL::getInstance()->mouseClickEvent(button, state))
+    if (Validator::valPtr->mouseClickEvent(button, state))
     {
         Validator::valPtr->setCursorPos(std::make_pair(x, y));
 
         if (Validator::valPtr->recordMeasurement())
         {
+            // show the next target now, rather than on the next timer
             Validator::valPtr->setShowingTarget(false);
+            Validator::valPtr->run();
         }
     }
 }
 
 void Validator::startUI(int *argcp, char **argvp)
+{
+    if (config.headless)
+    {
+        startUI(new ValidatorUIHeadless(getTargetSize(), getTargetType(),
+                                        DisplayGeometry::get().getResolution(),
+                                        ValidatorUIHeadless::defaultClickDelay,
+                                        config.preview));
+    }
+    else
+    {
+        startUI(ValidatorUIOpenGL::create(getTargetSize(), getTargetType(),
+                                          argcp, argvp, config.preview));
+    }
+}
+
+void Validator::startUI(ValidatorUI *newUI)
 {
     // just in case - for normal use this should not be initialised
     delete ui;
 
-    ui = ValidatorUIOpenGL::create(getTargetSize(), getTargetType(),
-                                   argcp, argvp, config.preview);
-    ui->setIdleFunc(&idleFunc);
+    ui = newUI;
+    ui->setTimerFunc(&timerFunc, runInterval);
     ui->setMouseFunc(&onClickFunc);
     ui->run();
 }
@@ -187,37 +235,108 @@ bool Validator::recordMeasurement()
 {
     bool success = false;
 
-    // lock both objects together - we want the data to be as close as we can
-    gazePosition->lock();
+    // The gaze store is lock-free and the newest sample is read in one go,
+    // so only the cursor needs locking. This never blocks the collector.
     cursorPosition->lock();
 
     // if the cursor didn't click the target, ignore it.
     if (cursorOverTarget())
     {
-        std::chrono::time_point<std::chrono::system_clock> currTime
-            = std::chrono::system_clock::now();
-
-        std::pair<unsigned int, unsigned int> tPos = getTargetPos();
-        std::pair<unsigned int, unsigned int> cPos = getCursorPos();
-        std::pair<std::pair<unsigned int, unsigned int>, std::pair<unsigned int, unsigned int> > gPos = getGazePosRightLeft();
-
-        if (data->writeData(currTime, getTargetIndex(),
-                            tPos.first, tPos.second,
-                            cPos.first, cPos.second,
-                            gPos.first.first, gPos.first.second,
-                            gPos.second.first, gPos.second.second))
-        {
-            ++testCount[getTargetIndex()];
-            success = true;
-        }
+        success = writeMeasurement(getCursorPos(), gazePosition->getLatestSample(),
+                                   std::chrono::steady_clock::now());
     }
 
-    gazePosition->unlock();
     cursorPosition->unlock();
 
+    // a click beat the dwell trigger to it
+    if (success && dwellTrigger != nullptr)
+    {
+        dwellTrigger->disarm();
+    }
+
     return success;
 }
 
+bool Validator::mouseClickEvent(int button, int state)
+{
+    // this should never happen
+    if (ui == nullptr)
+    {
+        throw std::runtime_error("onClickFunc called before UI was started!");
+    }
+
+    return ui->mouseClickEvent(button, state);
+}
+
+bool Validator::writeMeasurement(std::pair<unsigned int, unsigned int> cPos,
+                                 const GazeSample &gaze,
+                                 std::chrono::steady_clock::time_point now)
+{
+    // when the target appeared on the screen, if it has been drawn
+    const std::chrono::steady_clock::time_point shown
+        = (ui != nullptr ? ui->getTargetOnset() : std::chrono::steady_clock::time_point());
+    const bool haveOnset = (shown != std::chrono::steady_clock::time_point());
+    TargetOnset onset;
+    if (haveOnset)
+    {
+        onset.reactionTime = std::chrono::duration<double, std::milli>(now - shown).count();
+    }
+
+    // too soon after the target appeared (or before it did) to be a response
+    // to it
+    if (config.minReactionTime > 0.0
+        && (!haveOnset || onset.reactionTime < config.minReactionTime))
+    {
+        ++anticipatoryCount;
+        return false;
+    }
+
+    // wall clock times of the measurement, for the timestamp, and of the onset
+    const std::chrono::steady_clock::time_point steadyNow = std::chrono::steady_clock::now();
+    const std::chrono::time_point<std::chrono::system_clock> systemNow
+        = std::chrono::system_clock::now();
+    std::chrono::time_point<std::chrono::system_clock> currTime
+        = systemNow - std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            steadyNow - now);
+    if (haveOnset)
+    {
+        onset.shown = systemNow - std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            steadyNow - shown);
+    }
+
+    std::pair<unsigned int, unsigned int> tPos = getTargetPos();
+
+    // how long ago the tracker took the gaze sample we're using
+    double gazeAge = std::chrono::duration<double, std::milli>(
+        now - gaze.sampleTime).count();
+
+    // and the gaze over the measurement window leading up to now
+    GazeWindowStats window = windowAggregator.aggregate(
+        *gazePosition, now - std::chrono::milliseconds(config.measureWindow), now);
+
+    // and the fixation the subject made on this target, since it was on the
+    // screen (or asked for, if it hasn't been drawn)
+    Fixation fixation;
+    bool haveFixation = fixationTracker->getFixation(
+        (haveOnset ? shown : targetRequested), fixation);
+
+    if (!data->writeData(currTime, getTargetIndex(),
+                         tPos.first, tPos.second,
+                         cPos.first, cPos.second,
+                         gaze.right.first, gaze.right.second,
+                         gaze.left.first, gaze.left.second,
+                         gazeAge, window,
+                         (haveFixation ? &fixation : nullptr),
+                         (haveOnset ? &onset : nullptr)))
+    {
+        return false;
+    }
+
+    ++testCount[getTargetIndex()];
+    validationStats->add(getTargetIndex(), tPos.first, tPos.second, window);
+    return true;
+}
+
 void Validator::run()
 {
     // make sure the ui is initialised
@@ -226,12 +345,42 @@ void Validator::run()
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
 
+    updateGazePos();
+
+    // measure if the gaze has dwelled on the target. This is measured as of
+    // the sample which completed the dwell, and there's no click, so no
+    // cursor position.
+    GazeSample gaze;
+    if (getShowingTarget() && dwellTrigger != nullptr && dwellTrigger->poll(gaze))
+    {
+        if (writeMeasurement(std::make_pair(common::invalidCoord, common::invalidCoord),
+                             gaze, gaze.arrival))
+        {
+            setShowingTarget(false);
+        }
+        else
+        {
+            // it wasn't recorded (e.g. it was anticipatory) - wait for
+            // another dwell
+            dwellTrigger->arm(getTargetPos());
+        }
+    }
+
     // if we're done testing, clean everything up
     if (testingDone())
     {
         stopUI();
         std::cout << "Validator finished!" << std::endl;
         data->writeBuffer();
+        std::cout << "Output: " << data->getStats() << std::endl;
+        std::cout << "Display latency (target asked for to on screen): "
+                  << ui->getDisplayLatency();
+        if (config.minReactionTime > 0.0)
+        {
+            std::cout << "Anticipatory measurements ignored: " << anticipatoryCount
+                      << std::endl;
+        }
+        writeSummary();
         return;
     }
 
@@ -247,20 +396,47 @@ void Validator::run()
     {
         showTarget();
     }
+}
+
+void Validator::writeSummary()
+{
+    if (summaryWritten)
+    {
+        return;
+    }
+    summaryWritten = true;
+
+    std::cout << std::endl
+        << "========= accuracy and precision summary (" << validationStats->getUnits()
+        << ") =========" << std::endl;
+    validationStats->write(std::cout);
+    std::cout << "=========================================================" << std::endl
+        << std::endl;
 
-    // if we get here then there's nothing to do!
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    if (config.outputFile != "")
+    {
+        const std::string path = config.outputFile + ".summary.csv";
+        std::ofstream summaryFile(path);
+        if (summaryFile.is_open())
+        {
+            validationStats->write(summaryFile);
+            std::cout << "Summary written to " << path << std::endl;
+        }
+        else
+        {
+            std::cerr << "Could not write summary to " << path << std::endl;
+        }
+    }
 }
 
 bool Validator::testingDone() const
 {
     bool done = true;
 
-    // simply loop through the testCount countainer and see if every element
-    // is equal to (or greater than - shouldn't happen!) the number of reps.
-    for (auto count : testCount)
+    // simply loop through the targets and see if every one is done
+    for (unsigned int index = 0; index < testCount.size(); ++index)
     {
-        if (count < getReps())
+        if (!targetDone(index))
         {
             done = false;
             break;
@@ -270,6 +446,77 @@ bool Validator::testingDone() const
     return done;
 }
 
+bool Validator::targetDone(unsigned int index) const
+{
+    // repeats is the maximum, whether or not we're stopping early
+    if (testCount[index] >= getReps())
+    {
+        return true;
+    }
+
+    // in adaptive mode, stop once the accuracy is known well enough
+    return config.stopWidth > 0.0
+        && testCount[index] >= config.minRepeats
+        && validationStats->getAccuracyWidth(index) <= config.stopWidth;
+}
+
+unsigned int Validator::pickTarget() const
+{
+    // Pick a random position which has not been fully tested yet.
+    // This was seeded in the constructor.
+    if (config.stopWidth <= 0.0)
+    {
+        unsigned int randomIndex;
+        do
+        {
+            randomIndex = rand() % testCount.size();
+        } while (targetDone(randomIndex));
+
+        return randomIndex;
+    }
+
+    // In adaptive mode, favour the targets furthest from converging: the
+    // weight is how many times too wide the accuracy interval is (capped),
+    // and targets without enough measurements to tell get the maximum.
+    static const double maxWeight = 4.0;
+    double total = 0.0;
+    for (unsigned int index = 0; index < testCount.size(); ++index)
+    {
+        if (!targetDone(index))
+        {
+            total += targetWeight(index, maxWeight);
+        }
+    }
+
+    double pick = total * rand() / (static_cast<double>(RAND_MAX) + 1.0);
+    unsigned int last = 0;
+    for (unsigned int index = 0; index < testCount.size(); ++index)
+    {
+        if (!targetDone(index))
+        {
+            last = index;
+            pick -= targetWeight(index, maxWeight);
+            if (pick < 0.0)
+            {
+                break;
+            }
+        }
+    }
+
+    return last;
+}
+
+double Validator::targetWeight(unsigned int index, double maxWeight) const
+{
+    if (testCount[index] < config.minRepeats)
+    {
+        return maxWeight;
+    }
+
+    return std::min(maxWeight,
+                    validationStats->getAccuracyWidth(index) / config.stopWidth);
+}
+
 std::pair<unsigned int, unsigned int>
     Validator::indexToColRow(unsigned int index) const
 {
@@ -309,28 +556,56 @@ void Validator::showTarget()
                 "Cannot show new target - testing already complete.");
         }
 
-        // Pick a random position which has not been fully tested yet.
-        // This was seeded in the constructor.
-        unsigned int randomIndex;
-        do
-        {
-            randomIndex = rand() % testCount.size();
-        } while (testCount[randomIndex] >= getReps());
-
-        setTargetPos(randomIndex);
+        setTargetPos(pickTarget());
         ui->showTarget(getTargetPos());
+
+        if (dwellTrigger != nullptr)
+        {
+            dwellTrigger->arm(getTargetPos());
+        }
     }
+    targetRequested = std::chrono::steady_clock::now();
     setShowingTarget(true);
 }
 
 void Validator::startTrackerDataCollector()
 {
-    trackerDataCollector->run();
+    // start recording first so we don't miss the first samples
+    if (!config.recordFile.empty() && gazeRecorder == nullptr)
+    {
+        gazeRecorder = new GazeRecorder(*gazePosition, config.recordFile);
+        gazeRecorder->start();
+    }
+    fixationTracker->start();
+
+    try
+    {
+        trackerDataCollector->run();
+    }
+    catch (...)
+    {
+        // nothing will feed them now
+        fixationTracker->stop();
+        if (gazeRecorder != nullptr)
+        {
+            gazeRecorder->stop();
+        }
+        throw;
+    }
 }
 
 void Validator::stopTrackerDataCollector()
 {
+    fixationTracker->stop();
     trackerDataCollector->stop();
+
+    if (gazeRecorder != nullptr)
+    {
+        gazeRecorder->stop();
+        std::cout << "Gaze recording: " << gazeRecorder->getRecordedCount()
+                  << " samples written to " << config.recordFile << ", "
+                  << gazeRecorder->getLostCount() << " lost" << std::endl;
+    }
 }
 
 std::pair<unsigned int, unsigned int> Validator::getCursorPos() const
@@ -375,13 +650,14 @@ bool Validator::cursorOverTarget() const
                 <= std::pow(radius, 2.0);
 }
 
-void Validator::setTargetPos(unsigned int index)
+std::pair<unsigned int, unsigned int>
+    Validator::indexToTargetPos(unsigned int index) const
 {
     // first we need to calculate the row and column.
     std::pair<unsigned int, unsigned int> colRowPair = indexToColRow(index);
 
     // from this, define the bounding box based on the screen res.
-    std::pair<unsigned int, unsigned int> screenRes = common::getScreenRes();
+    std::pair<unsigned int, unsigned int> screenRes = DisplayGeometry::get().getResolution();
 
     // we are zero-indexing, so set the max x- and y- values as one less than
     // the full screen resolution
@@ -410,7 +686,12 @@ void Validator::setTargetPos(unsigned int index)
     }
 
     // the target will be in the middle of this cell
-    targetPosition->setCurrentPositionSingle(std::make_pair(xTarget, yTarget));
+    return std::make_pair(xTarget, yTarget);
+}
+
+void Validator::setTargetPos(unsigned int index)
+{
+    targetPosition->setCurrentPositionSingle(indexToTargetPos(index));
     targetIndex = index;
 }
 
@@ -448,6 +729,11 @@ bool Validator::getShowingTarget() const
 void Validator::setShowingTarget(bool isShowing)
 {
     showingTarget = isShowing;
+
+    if (gazeRecorder != nullptr)
+    {
+        gazeRecorder->setTarget(getTargetIndex(), isShowing);
+    }
 }
 
 unsigned int Validator::getTargetIndex() const
@@ -4,16 +4,24 @@
 #ifndef VALIDATOR_H
 #define VALIDATOR_H
 
+#include "DwellTrigger.h"
+#include "FixationDetector.h"
+#include "GazeRecording.h"
+#include "GazeWindowStats.h"
 #include "MeasuredData.h"
+#include "MeasuredDataAsync.h"
 #include "ScreenPositionStore.h"
 #include "TrackerConfig.h"
 #include "TrackerDataCollector.h"
+#include "ValidationStats.h"
 #include "ValidatorConfig.h"
 #include "ValidatorUI.h"
+#include "VisualAngle.h"
 
+#include <chrono>
+#include <cstdint>
 #include <utility> // for std::pair
 #include <string>
-#include <thread>
 #include <vector>
 
 class Validator
@@ -22,15 +30,39 @@ class Validator
     // Are we showing a target (and waiting for user input?)
     bool showingTarget;
 
-    // Data store for measured data.
-    MeasuredData *data;
+    // Data store for measured data. Measurements are queued, and written on
+    // another thread.
+    MeasuredDataAsync *data;
+
+    // Accuracy and precision of the measurements so far, and has the
+    // summary been written?
+    ValidationStats *validationStats;
+    bool summaryWritten;
+
+    // Pixel to degree conversion for each target, or nullptr if we don't
+    // know the screen geometry.
+    VisualAngleConverter *visualAngle;
+
+    // Triggers measurements when the gaze dwells on the target, or nullptr
+    // if measurements are only made by clicking.
+    DwellTrigger *dwellTrigger;
+
+    // print the summary, and write it next to the output file if there is one
+    void writeSummary();
 
     TrackerDataCollector *trackerDataCollector;
 
-    // thread for displaying the current gaze position
-    std::thread *gazePosThread;
-    bool showGaze;
-    void collectGazePos();
+    // writes every raw gaze sample to config.recordFile (nullptr if not
+    // recording)
+    GazeRecorder *gazeRecorder;
+
+    // number of gaze samples received when the gaze position was last
+    // shown, and show it again if there are new ones
+    std::uint64_t gazeSamplesShown;
+    void updateGazePos();
+
+    // measurements ignored as they were too soon after the target appeared
+    unsigned int anticipatoryCount;
 
     // Grid dimensions (cols, rows).
     std::pair<unsigned int, unsigned int> dimensions;
@@ -45,6 +77,12 @@ class Validator
     // Current position data for gaze.
     ScreenPositionStore *gazePosition;
 
+    // Summarises the gaze before each measurement.
+    GazeWindowAggregator windowAggregator;
+
+    // Finds the fixation made on each target.
+    FixationTracker *fixationTracker;
+
     // Current position data for the cursor.
     ScreenPositionStore *cursorPosition;
 
@@ -52,9 +90,20 @@ class Validator
     ScreenPositionStore *targetPosition;
     unsigned int targetIndex;
 
+    // When the current target was asked for. It's on the screen from
+    // ui->getTargetOnset(), once it has been drawn.
+    std::chrono::steady_clock::time_point targetRequested;
+
     // User interface
     ValidatorUI* ui;
 
+    // Write a measurement of the current target, made at time now with the
+    // given cursor position and gaze sample.
+    // @returns true if it was written
+    bool writeMeasurement(std::pair<unsigned int, unsigned int> cPos,
+                          const GazeSample &gaze,
+                          std::chrono::steady_clock::time_point now);
+
     // Get the current cursor position.
     std::pair<unsigned int, unsigned int> getCursorPos() const;
 
@@ -73,6 +122,17 @@ class Validator
     // Have all points been tested yet?
     bool testingDone() const;
 
+    // Has this point been tested enough? This is after the configured
+    // repeats, or in adaptive mode (config.stopWidth set) once its accuracy
+    // has converged.
+    bool targetDone(unsigned int index) const;
+
+    // Choose the next point to test, from those not done.
+    unsigned int pickTarget() const;
+
+    // How strongly to favour a point in adaptive mode (up to maxWeight).
+    double targetWeight(unsigned int index, double maxWeight) const;
+
     // Show the next target. The position of the next target is randomised
     // based on cells left to test.
     void showTarget();
@@ -80,11 +140,18 @@ class Validator
     // convert a position index into a (col, row) pair (zero indexed).
     std::pair<unsigned int, unsigned int> indexToColRow(unsigned int index) const;
 
+    // convert a position index into the target's screen position.
+    std::pair<unsigned int, unsigned int> indexToTargetPos(unsigned int index) const;
+
   public:
 
     // Workaround to get the UI idle functions working
     static Validator* valPtr;
 
+    // how often the UI calls run() (ms). This is well under a frame, so a
+    // new target or gaze position is drawn on the next frame.
+    static constexpr unsigned int runInterval = 4;
+
     // Constructor
     // The screen will be split into a grid of dimensions (columns, rows).
     // A target will be placed in the center of each grid cell, and cells will
@@ -95,11 +162,15 @@ class Validator
     // Destructor
     ~Validator();
 
-    // Run the validation routine.
+    // Run the validation routine. This is called on the UI thread every
+    // runInterval ms, and straight after a measurement is made.
     void run();
 
     // start/stop the UI
+    // The first form creates the UI (OpenGL, or headless if configured);
+    // the second runs the one given, and takes ownership of it.
     void startUI(int* argcp, char** argvp);
+    void startUI(ValidatorUI *newUI);
     void stopUI();
     void refreshUI();
 
@@ -124,6 +195,11 @@ class Validator
     // @returns false if the cursor was not over the target.
     bool recordMeasurement();
 
+    // Is this button/state combination a click, as far as the UI is
+    // concerned?
+    // @throws std::runtime_error if the UI hasn't been started
+    bool mouseClickEvent(int button, int state);
+
     // -- getters and setters -- //
     unsigned int getReps() const;
     unsigned int getTargetSize() const;
@@ -21,6 +21,29 @@ std::ostream &operator<<(std::ostream &str,
         << "  trackerConfig = " << config.trackerConfig << std::endl
         << "  subject = " << config.subject << std::endl
         << "  outputFile = " << config.outputFile << std::endl
-        << "  preview = " << (config.preview ? "true" : "false") << std::endl;
+        << "  outputsync = " << config.outputSync << std::endl
+        << "  recordFile = " << config.recordFile << std::endl
+        << "  measurewindow = " << config.measureWindow << std::endl
+        << "  fixationmethod = " << config.fixationMethod << std::endl
+        << "  fixationthreshold = " << config.fixationThreshold << std::endl
+        << "  screenwidth = " << config.screenWidth << std::endl
+        << "  screenheight = " << config.screenHeight << std::endl
+        << "  distance = " << config.viewingDistance << std::endl
+        << "  stopwidth = " << config.stopWidth << std::endl
+        << "  minrepeats = " << config.minRepeats << std::endl
+        << "  dwell = " << config.dwellTime << std::endl
+        << "  dwellradius = " << config.dwellRadius << std::endl
+        << "  minreaction = " << config.minReactionTime << std::endl
+        << "  preview = " << (config.preview ? "true" : "false") << std::endl
+        << "  headless = " << (config.headless ? "true" : "false") << std::endl;
+    if (config.tracker == "synthetic")
+    {
+        const SyntheticGazeModel &model = config.trackerConfig.synthetic;
+        str << "  synthnoise = " << model.right.whiteNoise << std::endl
+            << "  synthpink = " << model.right.pinkNoise << std::endl
+            << "  synthblinks = " << model.blinkRate << std::endl
+            << "  synthdropout = " << model.right.dropoutRate << std::endl
+            << "  synthseed = " << model.seed << std::endl;
+    }
     return str;
 }
\ No newline at end of file
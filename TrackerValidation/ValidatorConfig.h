@@ -23,8 +23,22 @@ class ValidatorConfig
     std::string trackerLabel;
     std::string tracker;
     std::string subject;
+    int outputSync; // ms between forcing the output file to disk, 0 for every batch, -1 for never
+    std::string recordFile; // raw gaze (and target) recording, or "" to not record
+    unsigned int measureWindow; // ms of gaze before each measurement to summarise
+    std::string fixationMethod; // "ivt" (velocity) or "idt" (dispersion)
+    double fixationThreshold; // pixels/s or pixels, or 0 for the method default
+    double screenWidth; // mm, or 0 if not known
+    double screenHeight; // mm, or 0 if not known
+    double viewingDistance; // eye to screen in mm, or 0 if not known
+    double stopWidth; // retire targets once their accuracy CI is this wide (0 = off)
+    unsigned int minRepeats; // fewest repeats before a target can be retired
+    unsigned int dwellTime; // ms of gaze on target to trigger a measurement (0 = click only)
+    double dwellRadius; // pixels from the target centre counted as on target
+    double minReactionTime; // ms after the target appears before measurements count (0 = off)
     TrackerConfig trackerConfig;
     bool preview;
+    bool headless; // run without a display, clicking each target automatically
 
     ValidatorConfig(unsigned int columns = 5,
                     unsigned int rows = 3,
@@ -41,9 +55,13 @@ class ValidatorConfig
                     TrackerConfig trackerConfig = TrackerConfig("127.0.0.1", 4242))
         : cols(columns), rows(rows), repeats(repeats), padding(padding),
           targetSize(targetSize), targType(targType), targLocation(targLocation),
-          trackerLabel(trackerLabel), tracker(tracker),
-          trackerConfig(trackerConfig), subject(subject),
-          preview(preview), outputFile(outputFile)
+          outputFile(outputFile), trackerLabel(trackerLabel), tracker(tracker),
+          subject(subject), outputSync(0), recordFile(""),
+          measureWindow(250), fixationMethod("ivt"), fixationThreshold(0.0),
+          screenWidth(0.0), screenHeight(0.0), viewingDistance(0.0),
+          stopWidth(0.0), minRepeats(2), dwellTime(0), dwellRadius(50.0),
+          minReactionTime(0.0),
+          trackerConfig(trackerConfig), preview(preview), headless(false)
     {}
 
     friend std::ostream& operator<<(std::ostream & str,
@@ -6,9 +6,45 @@
 ValidatorUI::ValidatorUI(unsigned int targetSize,
                          const std::string &targetType,
                          bool previewMode)
-    :targSize(targetSize), targType(targetType), preview(previewMode)
+    :targSize(targetSize), targType(targetType), preview(previewMode),
+     onsetPending(false)
 { }
 
+void ValidatorUI::targetRequested()
+{
+    onsetRequested = std::chrono::steady_clock::now();
+    onset = std::chrono::steady_clock::time_point();
+    onsetPending = true;
+}
+
+void ValidatorUI::targetDrawn()
+{
+    if (!onsetPending)
+    {
+        return;
+    }
+
+    onset = std::chrono::steady_clock::now();
+    onsetPending = false;
+    displayLatency.add(std::chrono::duration<double, std::milli>(
+        onset - onsetRequested).count());
+}
+
+bool ValidatorUI::targetPending() const
+{
+    return onsetPending;
+}
+
+std::chrono::steady_clock::time_point ValidatorUI::getTargetOnset() const
+{
+    return onset;
+}
+
+const LatencyHistogram &ValidatorUI::getDisplayLatency() const
+{
+    return displayLatency;
+}
+
 unsigned int ValidatorUI::getTargetSize() const
 {
     return targSize;
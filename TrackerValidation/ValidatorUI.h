@@ -4,6 +4,9 @@
 #ifndef VALIDATORUI_H
 #define VALIDATORUI_H
 
+#include "DisplayTiming.h"
+
+#include <chrono>
 #include <string>
 #include <utility> // for std::pair
 
@@ -14,10 +17,31 @@ class ValidatorUI
     std::string targType;
     bool preview;
 
+    // when the current target was asked for, and when it was first on the
+    // screen (time_point() until then)
+    std::chrono::steady_clock::time_point onsetRequested;
+    std::chrono::steady_clock::time_point onset;
+    bool onsetPending;
+
+    // time from asking for each target to it being on the screen
+    LatencyHistogram displayLatency;
+
+  protected:
+    // A new target has been asked for. Call this before drawing it.
+    void targetRequested();
+
+    // The target asked for has been drawn, and the buffer swap has
+    // completed. Only the first call after targetRequested() counts.
+    void targetDrawn();
+
+    // is a target waiting to be drawn?
+    bool targetPending() const;
+
   public:
     ValidatorUI(unsigned int targetSize,
                 const std::string &targetType,
                 bool previewMode = false);
+    virtual ~ValidatorUI() {}
 
     // display the target at the given (x,y) pixel location.
     // @param pos (x, y) pixel co-ordinates for the center of the target
@@ -29,18 +53,25 @@ class ValidatorUI
                             bool drawScreen = true,
                             bool firstTarget = true) = 0;
 
-    // set the gaze position so the UI can (optionally) display it.
+    // set the gaze position so the UI can (optionally) display it. The UI
+    // redraws whatever shows the gaze itself, without redrawing the target.
     virtual void setGazePos(std::pair<unsigned int, unsigned int> posRight,
                             std::pair<unsigned int, unsigned int> posLeft) = 0;
 
-    // set the idle routine (main processing)
-    virtual void setIdleFunc(void (*func)(void)) = 0;
+    // set the routine for the main processing, which is called on the UI
+    // thread every interval ms. The UI sleeps in between, unless it has
+    // something to draw or an input event arrives.
+    virtual void setTimerFunc(void (*func)(void), unsigned int interval) = 0;
 
     // set the function used for mouse click events
     // this is the format for GLUT routines but should be flexible
     // enough for other UI systems if needed.
     virtual void setMouseFunc(void (*func)(int, int, int, int)) = 0;
 
+    // mouseclick event helper - check if the button/state combination passed
+    // to the mouse function is considered a valid mouse click
+    virtual bool mouseClickEvent(int button, int state) = 0;
+
     virtual void run() = 0;
     virtual void stop() = 0;
     virtual void refresh() = 0;
@@ -50,6 +81,13 @@ class ValidatorUI
     // @ returns false if not ready to show targets (in menu, etc.)
     virtual bool inTestRoutine() const = 0;
 
+    // When the current target was first on the screen, or time_point() if
+    // it hasn't been drawn yet.
+    std::chrono::steady_clock::time_point getTargetOnset() const;
+
+    // time (ms) from asking for each target to it being on the screen
+    const LatencyHistogram &getDisplayLatency() const;
+
     // -- getters and setters -- //
     unsigned int getTargetSize() const;
     const std::string &getTargetType() const;
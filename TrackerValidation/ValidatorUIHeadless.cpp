@@ -0,0 +1,189 @@
+// Headless implementation of the validator UI
+
+#include "ValidatorUIHeadless.h"
+
+#include "common.h"
+#include "DisplayGeometry.h"
+
+#include <stdexcept>
+
+const std::pair<unsigned int, unsigned int> ValidatorUIHeadless::defaultResolution(1920, 1080);
+
+ValidatorUIHeadless::ValidatorUIHeadless(unsigned int targetSize,
+                                         const std::string &targType,
+                                         std::pair<unsigned int, unsigned int> resolution,
+                                         unsigned int clickDelay,
+                                         bool previewMode)
+    : ValidatorUI(targetSize, targType, previewMode),
+      resolution(resolution), clickDelay(clickDelay), running(false),
+      timerFunc(nullptr), timerInterval(0), mouseFunc(nullptr),
+      frameDue(false), targetTicks(0),
+      posRight(common::invalidCoord, common::invalidCoord),
+      posLeft(common::invalidCoord, common::invalidCoord),
+      ticks(0), frames(0), clicks(0)
+{
+    if (resolution.first == 0 || resolution.second == 0)
+    {
+        throw std::runtime_error("Headless UI resolution must not be zero");
+    }
+
+    // targets are placed on the pretend display, not the real one (if any)
+    DisplayGeometry::get().setResolution(resolution);
+}
+
+void ValidatorUIHeadless::showTarget(std::pair<unsigned int, unsigned int> pos,
+                                     bool drawScreen, bool firstTarget)
+{
+    if (firstTarget)
+    {
+        currTargetPos.clear();
+        targetRequested();
+    }
+    currTargetPos.push_back(pos);
+
+    if (drawScreen)
+    {
+        frameDue = true;
+    }
+}
+
+void ValidatorUIHeadless::setGazePos(std::pair<unsigned int, unsigned int> right,
+                                     std::pair<unsigned int, unsigned int> left)
+{
+    posRight = right;
+    posLeft = left;
+}
+
+void ValidatorUIHeadless::setTimerFunc(void (*func)(void), unsigned int interval)
+{
+    timerFunc = func;
+    timerInterval = interval;
+}
+
+void ValidatorUIHeadless::setMouseFunc(void (*func)(int, int, int, int))
+{
+    mouseFunc = func;
+}
+
+void ValidatorUIHeadless::sendClick(std::pair<unsigned int, unsigned int> pos)
+{
+    ++clicks;
+    if (mouseFunc != nullptr)
+    {
+        mouseFunc(clickButton, clickState,
+                  static_cast<int>(pos.first), static_cast<int>(pos.second));
+    }
+}
+
+void ValidatorUIHeadless::run()
+{
+    if (timerFunc == nullptr)
+    {
+        throw std::runtime_error("Headless UI started without a timer function");
+    }
+
+    running = true;
+    while (running)
+    {
+        ++ticks;
+
+        // the frame asked for is on the "screen" straight away
+        if (frameDue)
+        {
+            frameDue = false;
+            ++frames;
+            if (targetPending())
+            {
+                targetDrawn();
+                targetTicks = 0;
+            }
+        }
+
+        // then the subject responds
+        if (!scriptedClicks.empty())
+        {
+            std::pair<unsigned int, unsigned int> pos = scriptedClicks.front();
+            scriptedClicks.pop_front();
+            sendClick(pos);
+        }
+        else if (clickDelay > 0 && !currTargetPos.empty() && !targetPending()
+                 && ++targetTicks >= clickDelay)
+        {
+            targetTicks = 0;
+            sendClick(currTargetPos.front());
+        }
+
+        // the click may have finished the session
+        if (running)
+        {
+            timerFunc();
+        }
+    }
+}
+
+void ValidatorUIHeadless::stop()
+{
+    running = false;
+}
+
+void ValidatorUIHeadless::refresh()
+{
+    frameDue = true;
+}
+
+bool ValidatorUIHeadless::inTestRoutine() const
+{
+    return running;
+}
+
+bool ValidatorUIHeadless::mouseClickEvent(int button, int state)
+{
+    // as for OpenGL, clicks don't count in preview mode
+    if (inPreviewMode())
+    {
+        return false;
+    }
+
+    return (button == clickButton && state == clickState);
+}
+
+void ValidatorUIHeadless::click(std::pair<unsigned int, unsigned int> pos)
+{
+    scriptedClicks.push_back(pos);
+}
+
+// -- getters -- //
+const std::pair<unsigned int, unsigned int> &ValidatorUIHeadless::getResolution() const
+{
+    return resolution;
+}
+
+const std::pair<unsigned int, unsigned int> &ValidatorUIHeadless::getGazePosRight() const
+{
+    return posRight;
+}
+
+const std::pair<unsigned int, unsigned int> &ValidatorUIHeadless::getGazePosLeft() const
+{
+    return posLeft;
+}
+
+std::uint64_t ValidatorUIHeadless::getTickCount() const
+{
+    return ticks;
+}
+
+std::uint64_t ValidatorUIHeadless::getFrameCount() const
+{
+    return frames;
+}
+
+std::uint64_t ValidatorUIHeadless::getClickCount() const
+{
+    return clicks;
+}
+
+std::uint64_t ValidatorUIHeadless::getSimulatedTime() const
+{
+    return ticks * timerInterval;
+}
@@ -0,0 +1,111 @@
+// Headless implementation of the validator UI, for running whole sessions
+// without a display, e.g. in automated tests and benchmarks.
+// Nothing is drawn: a frame asked for is "on screen" at the next timer tick,
+// and each target is clicked a set number of ticks after it's shown (or at
+// scripted positions). The timer runs on a simulated clock, so there is no
+// waiting between ticks and a session runs as fast as the validator can.
+
+#ifndef VALIDATORUIHEADLESS_H
+#define VALIDATORUIHEADLESS_H
+
+#include "ValidatorUI.h"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility> // for std::pair
+#include <vector>
+
+class ValidatorUIHeadless : public ValidatorUI
+{
+  private:
+    // the pretend display
+    std::pair<unsigned int, unsigned int> resolution;
+
+    // ticks from a target being on screen to clicking it, or 0 to not click
+    unsigned int clickDelay;
+
+    bool running;
+
+    // main processing routine, and how often it would be called (ms)
+    void (*timerFunc)(void);
+    unsigned int timerInterval;
+
+    void (*mouseFunc)(int, int, int, int);
+
+    // targets on the "screen", and has a frame been asked for?
+    std::vector<std::pair<unsigned int, unsigned int> > currTargetPos;
+    bool frameDue;
+
+    // ticks since the current target was drawn
+    unsigned int targetTicks;
+
+    // scripted clicks, sent one per tick ahead of the automatic ones
+    std::deque<std::pair<unsigned int, unsigned int> > scriptedClicks;
+
+    std::pair<unsigned int, unsigned int> posRight;
+    std::pair<unsigned int, unsigned int> posLeft;
+
+    std::uint64_t ticks;
+    std::uint64_t frames;
+    std::uint64_t clicks;
+
+    // send a left click at pos to the mouse routine
+    void sendClick(std::pair<unsigned int, unsigned int> pos);
+
+  public:
+    // The button and state sent for a click. These are the same as GLUT's
+    // left button down, so the same mouse routine can be used for both.
+    static const int clickButton = 0;
+    static const int clickState = 0;
+
+    // ticks to wait before clicking each target by default (one frame to
+    // draw it, then click on the next)
+    static const unsigned int defaultClickDelay = 1;
+
+    // resolution to pretend to have when there's no display to ask
+    static const std::pair<unsigned int, unsigned int> defaultResolution;
+
+    // The resolution is used for the display geometry, in place of looking
+    // it up from the real display.
+    ValidatorUIHeadless(unsigned int targetSize,
+                        const std::string &targType,
+                        std::pair<unsigned int, unsigned int> resolution,
+                        unsigned int clickDelay = defaultClickDelay,
+                        bool previewMode = false);
+
+    void showTarget(std::pair<unsigned int, unsigned int> pos,
+                    bool drawScreen = true, bool firstTarget = true);
+    void setGazePos(std::pair<unsigned int, unsigned int> posRight,
+                    std::pair<unsigned int, unsigned int> posLeft);
+    void setTimerFunc(void (*func)(void), unsigned int interval);
+    void setMouseFunc(void (*func)(int, int, int, int));
+
+    // Run the timer routine until stop() is called. Each tick draws any
+    // frame asked for, sends at most one click, then calls the timer
+    // routine.
+    // @throws std::runtime_error if there's no timer routine
+    void run();
+    void stop();
+    void refresh();
+
+    bool inTestRoutine() const;
+    bool mouseClickEvent(int button, int state);
+
+    // Click at pos on the next tick without a click, rather than on the
+    // target. Scripted clicks are sent in order, ahead of automatic ones.
+    void click(std::pair<unsigned int, unsigned int> pos);
+
+    // -- getters -- //
+    const std::pair<unsigned int, unsigned int> &getResolution() const;
+    const std::pair<unsigned int, unsigned int> &getGazePosRight() const;
+    const std::pair<unsigned int, unsigned int> &getGazePosLeft() const;
+    std::uint64_t getTickCount() const;
+    std::uint64_t getFrameCount() const;
+    std::uint64_t getClickCount() const;
+
+    // time on the simulated clock (ms): ticks x the timer interval
+    std::uint64_t getSimulatedTime() const;
+};
+
+#endif // not defined VALIDATORUIHEADLESS_H
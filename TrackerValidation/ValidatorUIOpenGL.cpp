@@ -3,12 +3,10 @@
 
 #include "ValidatorUIOpenGL.h"
 
-#include "common.h"
-#include "FixationTarget.h"
+#include "DisplayGeometry.h"
 
 #include <GL/freeglut.h>
 #include <iostream>
-#include <memory>
 #include <thread>
 
 // -- singleton initialisation -- //
@@ -33,6 +31,31 @@ ValidatorUIOpenGL *ValidatorUIOpenGL::getInstance()
 }
 
 // -- UI static functions -- //
+void ValidatorUIOpenGL::drawWindow(int x)
+{
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (!inTestRoutine())
+    {
+        showSplashScreen();
+    }
+    else
+    {
+        for (auto pos : currTargetPos)
+        {
+            drawTarget(pos.first, pos.second, getTargetSize());
+        }
+
+        // show our gaze positions as well on the monitor window
+        if (x != 0)
+        {
+            drawFixation(posRight.first, posRight.second);
+            drawFixation(posLeft.first, posLeft.second);
+        }
+    }
+    glutSwapBuffers();
+}
+
 void ValidatorUIOpenGL::drawScreen()
 {
     ValidatorUIOpenGL * const ui = ValidatorUIOpenGL::getInstance();
@@ -43,39 +66,43 @@ void ValidatorUIOpenGL::drawScreen()
         throw std::runtime_error("drawScreen() called before UI was started!");
     }
 
-    constexpr int numWindows = sizeof(ui->displayWindows) / sizeof(ui->displayWindows[0]);
-    for (int x = 0; x < numWindows && ui->keepRunning(); ++x)
+    if (!ui->keepRunning())
     {
-        // redraw the screen
-        glutSetWindow(ui->displayWindows[x]);
-        glClear(GL_COLOR_BUFFER_BIT);
+        return;
+    }
 
-        if (!ui->inTestRoutine())
-        {
-            ui->showSplashScreen();
-        }
-        else
-        {
-            for (auto pos : ui->currTargetPos)
-            {
-                ui->drawTarget(pos.first, pos.second, ui->getTargetSize());
-            }
-
-            // show our gaze positions as well on the monitor window
-            if (x != 0)
-            {
-                ui->drawFixation(ui->posRight.first, ui->posRight.second);
-                ui->drawFixation(ui->posLeft.first, ui->posLeft.second);
-            }
-        }
-        glutSwapBuffers();
+    ui->drawWindow(0);
+
+    // timestamp a new target once it's on the subject's screen. glFinish
+    // waits for the swap (with vsync, for the vertical blank), so this is
+    // when the subject could first see it.
+    if (ui->inTestRoutine() && ui->targetPending())
+    {
+        glFinish();
+        ui->targetDrawn();
     }
-    glutSetWindow(ui->displayWindows[0]);
+
+    // the monitor shows whatever the subject sees
+    glutPostWindowRedisplay(ui->displayWindows[1]);
 }
 
-// screen drawing is being handled by the main drawScreen method
+// the monitor window is drawn on its own, so gaze updates don't hold up the
+// subject's screen
 void ValidatorUIOpenGL::drawScreenMonitor()
-{}
+{
+    ValidatorUIOpenGL * const ui = ValidatorUIOpenGL::getInstance();
+
+    // this should never happen
+    if (ui == nullptr)
+    {
+        throw std::runtime_error("drawScreenMonitor() called before UI was started!");
+    }
+
+    if (ui->keepRunning())
+    {
+        ui->drawWindow(1);
+    }
+}
 
 void ValidatorUIOpenGL::keypress(unsigned char key, int, int)
 {
@@ -98,7 +125,7 @@ void ValidatorUIOpenGL::keypress(unsigned char key, int, int)
         if (!ui->fullscreen)
         {
             std::cout << "Changing to full-screen mode" << std::endl;
-            std::pair<unsigned int, unsigned int> res = common::getScreenRes();
+            std::pair<unsigned int, unsigned int> res = DisplayGeometry::get().getResolution();
             glutReshapeWindow(res.first, res.second);
             glutPositionWindow(0, 0);
             glutFullScreen();
@@ -122,12 +149,36 @@ void ValidatorUIOpenGL::resize(int width, int height)
 
     glViewport(0, 0, width, height);
 
+    // we may have moved to another monitor
+    DisplayGeometry::get().invalidate();
+
     if (!ui->fullscreen)
     {
         ui->showSplashScreen();
     }
 }
 
+void ValidatorUIOpenGL::timer(int)
+{
+    ValidatorUIOpenGL * const ui = ValidatorUIOpenGL::getInstance();
+
+    // this should never happen
+    if (ui == nullptr)
+    {
+        throw std::runtime_error("timer called before UI was started!");
+    }
+
+    if (!ui->keepRunning() || ui->timerFunc == nullptr)
+    {
+        return;
+    }
+
+    // GLUT timers only fire once. Set the next one first, so the interval
+    // doesn't include the time taken by timerFunc.
+    glutTimerFunc(ui->timerInterval, ui->timer, 0);
+    ui->timerFunc();
+}
+
 void ValidatorUIOpenGL::showSplashScreen()
 {
     static void *font = GLUT_BITMAP_HELVETICA_12;
@@ -161,20 +212,20 @@ bool ValidatorUIOpenGL::mouseClickEvent(int button, int state)
 void ValidatorUIOpenGL::drawTarget(unsigned int x, unsigned int y,
                                    unsigned int diameter)
 {
-    std::unique_ptr<FixationTarget> t(
-        FixationTarget::create(getTargetType(), diameter));
-    t->drawOpenGL(x, y);
+    if (!target || target->getDiameter() != diameter)
+    {
+        target.reset(FixationTarget::create(getTargetType(), diameter));
+    }
+    target->drawOpenGL(x, y);
 }
 
 void ValidatorUIOpenGL::drawFixation(unsigned int x, unsigned int y)
 {
-    std::pair<unsigned int, unsigned int> res = common::getScreenRes();
+    std::pair<unsigned int, unsigned int> res = DisplayGeometry::get().getResolution();
 
     if (x <= res.first && y <= res.second)
     {
-        std::unique_ptr<FixationTarget> t(
-            FixationTarget::create("circle", 10));
-        t->drawOpenGL(x, y);
+        gazeMarker->drawOpenGL(x, y);
     }
 }
 
@@ -184,6 +235,12 @@ void ValidatorUIOpenGL::setGazePos(
 {
     posRight = r;
     posLeft = l;
+
+    // only the monitor window shows the gaze
+    if (inTestRoutine())
+    {
+        glutPostWindowRedisplay(displayWindows[1]);
+    }
 }
 
 // -- end UI static functions --//
@@ -198,7 +255,10 @@ ValidatorUIOpenGL::ValidatorUIOpenGL(unsigned int targetSize,
                                      int *argcp, char **argvp,
                                      bool previewMode)
     : ValidatorUI(targetSize, targetType, previewMode),
-      fullscreen(false), running(true), currTargetPos()
+      fullscreen(false), running(true), currTargetPos(),
+      target(FixationTarget::create(targetType, targetSize)),
+      gazeMarker(FixationTarget::create("circle", 10)),
+      timerFunc(nullptr), timerInterval(0)
 {
     static constexpr std::pair<int, int> windowRes = std::make_pair(640, 480);
 
@@ -232,9 +292,16 @@ ValidatorUIOpenGL::ValidatorUIOpenGL(unsigned int targetSize,
     glutSetCursor(GLUT_CURSOR_CROSSHAIR);
 }
 
-void ValidatorUIOpenGL::setIdleFunc(void (*func)(void))
+void ValidatorUIOpenGL::setTimerFunc(void (*func)(void), unsigned int interval)
 {
-    glutIdleFunc(func);
+    // there's no idle function, so GLUT sleeps until an event or the timer
+    const bool started = (timerFunc != nullptr);
+    timerFunc = func;
+    timerInterval = interval;
+    if (!started)
+    {
+        glutTimerFunc(timerInterval, timer, 0);
+    }
 }
 
 void ValidatorUIOpenGL::setMouseFunc(void (*func)(int, int, int, int))
@@ -279,6 +346,7 @@ void ValidatorUIOpenGL::showTarget(std::pair<unsigned int, unsigned int> pos,
     if (firstTarget)
     {
         currTargetPos.clear();
+        targetRequested();
     }
     
     currTargetPos.push_back(std::make_pair(pos.first, pos.second));
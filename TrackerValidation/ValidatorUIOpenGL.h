@@ -6,9 +6,11 @@
 #ifndef VALIDATORUIOPENGL_H
 #define VALIDATORUIOPENGL_H
 
+#include "FixationTarget.h"
 #include "ValidatorUI.h"
 
 #include <GL/freeglut.h>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -33,14 +35,24 @@ class ValidatorUIOpenGL : public ValidatorUI
     bool running;
     static void drawScreen();
     static void drawScreenMonitor();
+
+    // draw the contents of window x (0 for the subject, 1 for the monitor)
+    // and swap its buffers. The window must be the current one.
+    void drawWindow(int x);
     static void keypress(unsigned char key, int x, int y);
     static void resize(int width, int height);
+    static void timer(int value);
     void showSplashScreen();
 
     // collection of target positions. Normally this will only have one item
     // but we may want to show multiple targets at once.
     std::vector<std::pair<unsigned int, unsigned int> > currTargetPos;
 
+    // the target and gaze position markers. These are kept so they're only
+    // built once, however often they are drawn.
+    std::unique_ptr<FixationTarget> target;
+    std::unique_ptr<FixationTarget> gazeMarker;
+
     // draw a target at pixel location (x, y) with the given radius.
     void drawTarget(unsigned int x, unsigned int y,
                     unsigned int diameter);
@@ -48,6 +60,10 @@ class ValidatorUIOpenGL : public ValidatorUI
     // draw fixation position at pixel location (x, y)
     void drawFixation(unsigned int x, unsigned int y);
 
+    // main processing routine, and how often it is called (ms)
+    void (*timerFunc)(void);
+    unsigned int timerInterval;
+
     // set the current gaze position, so we can draw it on our monitor.
     void setGazePos(std::pair<unsigned int, unsigned int> posRight,
                     std::pair<unsigned int, unsigned int> posLeft);
@@ -64,8 +80,8 @@ class ValidatorUIOpenGL : public ValidatorUI
     // returns nullptr if this has not yet been created
     static ValidatorUIOpenGL *getInstance();
 
-    // set the idle routine (main processing)
-    void setIdleFunc(void (*func)(void));
+    // set the main processing routine, called every interval ms
+    void setTimerFunc(void (*func)(void), unsigned int interval);
 
     // set the mouse click handler routine
     void setMouseFunc(void (*func)(int, int, int, int));
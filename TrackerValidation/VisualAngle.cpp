@@ -0,0 +1,116 @@
+// Conversion from screen pixels to degrees of visual angle.
+
+#include "VisualAngle.h"
+
+#include "common.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    const double degPerRad = 180.0 / common::pi;
+
+    double dot(const double a[3], const double b[3])
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+}
+
+bool ScreenGeometry::isValid() const
+{
+    return widthPx > 0 && heightPx > 0
+        && widthMm > 0.0 && heightMm > 0.0 && distanceMm > 0.0;
+}
+
+VisualAngleConverter::VisualAngleConverter(const ScreenGeometry &geometry)
+    : geometry(geometry)
+{
+    if (!geometry.isValid())
+    {
+        throw std::runtime_error("Screen size and viewing distance are needed for visual angles");
+    }
+
+    mmPerPxX = geometry.widthMm / geometry.widthPx;
+    mmPerPxY = geometry.heightMm / geometry.heightPx;
+}
+
+void VisualAngleConverter::toEyeSpace(double x, double y, double v[3]) const
+{
+    // pixel centres, relative to the centre of the screen
+    v[0] = (x + 0.5 - geometry.widthPx / 2.0) * mmPerPxX;
+    v[1] = (y + 0.5 - geometry.heightPx / 2.0) * mmPerPxY;
+    v[2] = geometry.distanceMm;
+}
+
+void VisualAngleConverter::setTarget(unsigned int index, double x, double y)
+{
+    if (index >= targets.size())
+    {
+        targets.resize(index + 1);
+    }
+
+    double v[3];
+    toEyeSpace(x, y, v);
+    const double r = std::sqrt(dot(v, v));
+    const double u[3] = { v[0] / r, v[1] / r, v[2] / r };
+
+    // horizontal direction as seen from the eye: the screen x axis, less its
+    // component along the line of sight
+    double e1[3] = { 1.0 - u[0] * u[0], -u[0] * u[1], -u[0] * u[2] };
+    const double len = std::sqrt(dot(e1, e1));
+    e1[0] /= len;
+    e1[1] /= len;
+    e1[2] /= len;
+
+    // and vertical (u x e1), which points the same way as screen y
+    const double e2[3] = { u[1] * e1[2] - u[2] * e1[1],
+                           u[2] * e1[0] - u[0] * e1[2],
+                           u[0] * e1[1] - u[1] * e1[0] };
+
+    // a small move on the screen turns the line of sight by the part of the
+    // move perpendicular to it, divided by the distance
+    Jacobian &j = targets[index];
+    j.xx = e1[0] * mmPerPxX / r * degPerRad;
+    j.xy = e1[1] * mmPerPxY / r * degPerRad;
+    j.yx = e2[0] * mmPerPxX / r * degPerRad;
+    j.yy = e2[1] * mmPerPxY / r * degPerRad;
+    j.scale = std::sqrt(std::fabs(j.xx * j.yy - j.xy * j.yx));
+}
+
+std::size_t VisualAngleConverter::getTargetCount() const
+{
+    return targets.size();
+}
+
+void VisualAngleConverter::toDegrees(unsigned int target, double dx, double dy,
+                                     double &degX, double &degY) const
+{
+    const Jacobian &j = targets.at(target);
+    degX = j.xx * dx + j.xy * dy;
+    degY = j.yx * dx + j.yy * dy;
+}
+
+double VisualAngleConverter::distanceToDegrees(unsigned int target, double px) const
+{
+    return targets.at(target).scale * px;
+}
+
+double VisualAngleConverter::angleBetween(double x1, double y1,
+                                          double x2, double y2) const
+{
+    double a[3], b[3];
+    toEyeSpace(x1, y1, a);
+    toEyeSpace(x2, y2, b);
+
+    // atan2 of |a x b| and a.b is accurate for small angles, unlike acos
+    const double c[3] = { a[1] * b[2] - a[2] * b[1],
+                          a[2] * b[0] - a[0] * b[2],
+                          a[0] * b[1] - a[1] * b[0] };
+    return std::atan2(std::sqrt(dot(c, c)), dot(a, b)) * degPerRad;
+}
+
+const ScreenGeometry &VisualAngleConverter::getGeometry() const
+{
+    return geometry;
+}
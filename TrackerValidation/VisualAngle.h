@@ -0,0 +1,82 @@
+// Conversion from screen pixels to degrees of visual angle.
+// The subject's eye is assumed to be level with the centre of the screen, at
+// a known distance. A pixel near the edge of the screen is further from the
+// eye, and seen at an angle, so it subtends less than one in the middle.
+//
+// The exact conversion needs trig for every value. Instead, for each target
+// we work out (once, at the start of a session) the Jacobian which maps a
+// small pixel offset from the target to an angular offset. Converting a
+// sample is then a couple of multiplies. This is accurate for offsets of a
+// few degrees, which is all a gaze error should ever be.
+
+#ifndef VISUALANGLE_H
+#define VISUALANGLE_H
+
+#include <cstddef>
+#include <vector>
+
+struct ScreenGeometry
+{
+    // resolution, in pixels
+    unsigned int widthPx;
+    unsigned int heightPx;
+
+    // physical size of the display area, and the eye to screen distance (mm)
+    double widthMm;
+    double heightMm;
+    double distanceMm;
+
+    // Do we have everything needed to convert to visual angle?
+    bool isValid() const;
+};
+
+class VisualAngleConverter
+{
+  private:
+    // degrees per pixel around a target. The angular axes are horizontal and
+    // vertical as seen from the eye, so off-axis targets have cross terms.
+    struct Jacobian
+    {
+        double xx, xy;
+        double yx, yy;
+
+        // degrees per pixel for distances (the geometric mean of the axes)
+        double scale;
+    };
+
+    ScreenGeometry geometry;
+    double mmPerPxX;
+    double mmPerPxY;
+
+    std::vector<Jacobian> targets;
+
+    // (x, y, z) in mm from the eye of a screen position
+    void toEyeSpace(double x, double y, double v[3]) const;
+
+  public:
+    // @throws std::runtime_error if the geometry is not valid
+    explicit VisualAngleConverter(const ScreenGeometry &geometry);
+
+    // Precompute the conversion for a target at pixel (x, y).
+    void setTarget(unsigned int index, double x, double y);
+
+    std::size_t getTargetCount() const;
+
+    // Convert a pixel offset (dx, dy) from a target into degrees.
+    // @throws std::out_of_range if the target has not been set
+    void toDegrees(unsigned int target, double dx, double dy,
+                   double &degX, double &degY) const;
+
+    // Convert a distance in pixels near a target (e.g. a spread of samples)
+    // into degrees.
+    // @throws std::out_of_range if the target has not been set
+    double distanceToDegrees(unsigned int target, double px) const;
+
+    // Exact angle between two screen positions, in degrees. This is much
+    // slower than the precomputed conversions.
+    double angleBetween(double x1, double y1, double x2, double y2) const;
+
+    const ScreenGeometry &getGeometry() const;
+};
+
+#endif // not defined VISUALANGLE_H
@@ -0,0 +1,159 @@
+// Benchmark: converting target vertices from pixels to OpenGL positions.
+// Compares looking up the screen resolution for every vertex (as
+// OpenGLPixelToPosition used to) with the cached DisplayGeometry, both per
+// vertex and with the transform fetched once per frame (as the targets do).
+// Each frame is the vertices of one crosshair bullseye target and the two
+// gaze position circles; no OpenGL context is needed.
+//
+// Usage: DisplayGeometry_bench [frames]
+// Needs a display to look up the resolution from.
+
+#include "../common.h"
+#include "../DisplayGeometry.h"
+#include "../OpenGLCommon.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace
+{
+    const int passes = 5;
+
+    // what's drawn each frame (see CrosshairBullseyeTarget and
+    // ValidatorUIOpenGL::drawScreen)
+    const unsigned int bullseyeSegments = 128;
+    const unsigned int circleSegments = 32;
+    const unsigned int targetDiameter = 20;
+
+    // OpenGLPixelToPosition before DisplayGeometry
+    std::pair<double, double> uncachedPixelToPosition(int xPixel, int yPixel)
+    {
+        std::pair<unsigned int, unsigned int> res = common::getScreenRes();
+        double xPos = 2 * (static_cast<double>(xPixel)
+                      / static_cast<double>(res.first)) - 1.0;
+        double yPos = 1.0 - (2 * (static_cast<double>(yPixel)
+                      / static_cast<double>(res.second)));
+
+        return std::make_pair(xPos, yPos);
+    }
+
+    template <typename F>
+    double fan(F toPosition, int x, int y, unsigned int diameter, unsigned int segments)
+    {
+        const double radius = static_cast<double>(diameter) / 2.0;
+        std::pair<double, double> pos = toPosition(x, y);
+        double sum = pos.first + pos.second;
+        for (double n = 0; n <= segments; ++n)
+        {
+            double sigma = n * common::pi * 2.0 / static_cast<double>(segments);
+            pos = toPosition(static_cast<int>(x + (radius * cos(sigma))),
+                             static_cast<int>(y + (radius * sin(sigma))));
+            sum += pos.first + pos.second;
+        }
+        return sum;
+    }
+
+    // the vertices of one frame
+    template <typename F>
+    double frame(F toPosition, int x, int y)
+    {
+        const int radius = targetDiameter / 2;
+        const int outerRadius = targetDiameter * 3 / 2;
+
+        double sum = fan(toPosition, x, y, targetDiameter * 3, bullseyeSegments);
+        const std::pair<int, int> corners[] = {
+            std::make_pair(x - outerRadius - 1, y - radius),
+            std::make_pair(x - radius, y - outerRadius - 1),
+            std::make_pair(x + outerRadius + 1, y + radius),
+            std::make_pair(x + radius, y + outerRadius + 1)
+        };
+        for (const std::pair<int, int> &c : corners)
+        {
+            std::pair<double, double> pos = toPosition(c.first, c.second);
+            sum += pos.first + pos.second;
+        }
+        sum += fan(toPosition, x, y, targetDiameter, bullseyeSegments);
+
+        // gaze positions
+        sum += fan(toPosition, x + 5, y - 3, 10, circleSegments);
+        sum += fan(toPosition, x - 4, y + 2, 10, circleSegments);
+        return sum;
+    }
+
+    template <typename F>
+    double bestOf(unsigned int frames, F func)
+    {
+        double best = 1e30;
+        for (int i = 0; i < passes; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (unsigned int f = 0; f < frames; ++f)
+            {
+                func(f);
+            }
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, ms / frames);
+        }
+        return best;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const unsigned int frames = (argc > 1 ? std::stoul(argv[1]) : 1000);
+
+    try
+    {
+        std::pair<unsigned int, unsigned int> res = DisplayGeometry::get().getResolution();
+        std::cout << "Screen resolution: " << res.first << "x" << res.second << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // keeps the work from being optimised away
+    double sink = 0.0;
+
+    // this is slow, so only do a few frames
+    const unsigned int uncachedFrames = std::max(1u, frames / 100);
+    double uncachedMs = bestOf(uncachedFrames, [&](unsigned int f) {
+        sink += frame(uncachedPixelToPosition, 400 + f % 100, 300);
+    });
+
+    double perVertexMs = bestOf(frames, [&](unsigned int f) {
+        sink += frame(OpenGLPixelToPosition, 400 + f % 100, 300);
+    });
+
+    auto cached = [](int x, int y) {
+        const PixelTransform transform = DisplayGeometry::get().getPixelTransform();
+        return frame([&](int px, int py) { return transform.toPosition(px, py); }, x, y);
+    };
+    double perFrameMs = bestOf(frames, [&](unsigned int f) {
+        sink += cached(400 + f % 100, 300);
+    });
+
+    // all three should draw the same thing
+    const double checksums[3] = {
+        frame(uncachedPixelToPosition, 400, 300),
+        frame(OpenGLPixelToPosition, 400, 300),
+        cached(400, 300)
+    };
+
+    std::cout << "Vertices per frame: " << 2 * (bullseyeSegments + 2) + 4
+                                           + 2 * (circleSegments + 2) << std::endl
+              << "Resolution per vertex:    " << uncachedMs * 1000.0 << " us/frame" << std::endl
+              << "Cached, per vertex:       " << perVertexMs * 1000.0 << " us/frame" << std::endl
+              << "Cached, once per frame:   " << perFrameMs * 1000.0 << " us/frame" << std::endl
+              << "Checksums: " << checksums[0] << " / " << checksums[1] << " / "
+              << checksums[2] << " (" << sink << ")" << std::endl;
+
+    return EXIT_SUCCESS;
+}
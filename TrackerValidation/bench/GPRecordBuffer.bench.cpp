@@ -0,0 +1,184 @@
+// Benchmark: splitting a burst of Open Gaze API data into records.
+// Compares the original string based framing in GPClient with GPRecordBuffer.
+//
+// Usage: GPRecordBuffer_bench [capture file]
+// The capture file should contain the raw stream from Gazepoint Control (one
+// record per line). If no file is given, 60 seconds of 150 Hz data is
+// generated, which is what arrives in one go after a 60 second stall.
+
+#include "../gazepoint/GPRecordBuffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    // matches RX_TCP_BUFFER_MAX in GPClient.cpp
+    const size_t chunkSize = 64000;
+    const int passes = 5;
+
+    std::string loadCapture(const char *path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            throw std::runtime_error(std::string("Could not open ") + path);
+        }
+
+        // normalise the line endings to what the server sends
+        std::string data, line;
+        while (std::getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            data += line + "\r\n";
+        }
+        return data;
+    }
+
+    std::string generateCapture(unsigned int seconds, unsigned int rate)
+    {
+        std::ostringstream out;
+        out.precision(5);
+        out << std::fixed;
+        for (unsigned int i = 0; i < seconds * rate; ++i)
+        {
+            double t = static_cast<double>(i) / rate;
+            out << "<REC CNT=\"" << 100000 + i << "\" TIME=\"" << t << "\""
+                << " LPOGX=\"0." << 40000 + (i * 7) % 20000 << "\" LPOGY=\"0.51234\" LPOGV=\"1\""
+                << " RPOGX=\"0." << 41000 + (i * 3) % 20000 << "\" RPOGY=\"0.49876\" RPOGV=\"1\" />\r\n";
+        }
+        return out.str();
+    }
+
+    // the framing GPClient used before GPRecordBuffer
+    size_t frameOriginal(const std::string &stream, std::deque<std::string> &records)
+    {
+        std::string rxstr;
+        char rxbuffer[chunkSize];
+        for (size_t pos = 0; pos < stream.size(); pos += chunkSize - 1)
+        {
+            size_t result = std::min(chunkSize - 1, stream.size() - pos);
+            std::memcpy(rxbuffer, stream.data() + pos, result);
+            rxbuffer[result] = '\0';
+            rxstr = rxstr + rxbuffer;
+
+            size_t delimiter_index = rxstr.find("\r\n", 0);
+            while (delimiter_index != std::string::npos && rxstr != "")
+            {
+                records.push_back(rxstr.substr(0, delimiter_index));
+                rxstr.erase(0, delimiter_index + 2);
+                delimiter_index = rxstr.find("\r\n", 0);
+            }
+        }
+        return records.size();
+    }
+
+    size_t frameRecordBuffer(const std::string &stream, GPRecordBuffer &buf,
+                             size_t &totalLength)
+    {
+        size_t count = 0;
+        std::string_view record;
+        for (size_t pos = 0; pos < stream.size();)
+        {
+            char *dest = buf.write_ptr();
+            size_t n = std::min(std::min(chunkSize, buf.write_space()),
+                                stream.size() - pos);
+            std::memcpy(dest, stream.data() + pos, n);
+            buf.commit(n);
+            pos += n;
+
+            while (buf.next_record(record))
+            {
+                totalLength += record.size();
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    template <typename F>
+    double bestOf(F func)
+    {
+        double best = 1e30;
+        for (int i = 0; i < passes; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            func();
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, ms);
+        }
+        return best;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string stream;
+    try
+    {
+        stream = (argc > 1 ? loadCapture(argv[1]) : generateCapture(60, 150));
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    size_t originalCount = 0, bufferCount = 0, totalLength = 0;
+
+    double originalMs = bestOf([&]() {
+        std::deque<std::string> records;
+        originalCount = frameOriginal(stream, records);
+    });
+
+    GPRecordBuffer buf(2 * chunkSize);
+    double bufferMs = bestOf([&]() {
+        buf.clear();
+        bufferCount = frameRecordBuffer(stream, buf, totalLength);
+    });
+
+    // also time the copy into a deque, which GPClient still does for get_rx()
+    double bufferCopyMs = bestOf([&]() {
+        std::deque<std::string> records;
+        std::string_view record;
+        buf.clear();
+        for (size_t pos = 0; pos < stream.size();)
+        {
+            char *dest = buf.write_ptr();
+            size_t n = std::min(std::min(chunkSize, buf.write_space()),
+                                stream.size() - pos);
+            std::memcpy(dest, stream.data() + pos, n);
+            buf.commit(n);
+            pos += n;
+            while (buf.next_record(record))
+            {
+                records.emplace_back(record);
+            }
+        }
+    });
+
+    std::cout << "Stream: " << stream.size() << " bytes" << std::endl
+              << "Original framing:        " << originalMs << " ms ("
+              << originalCount << " records)" << std::endl
+              << "GPRecordBuffer:          " << bufferMs << " ms ("
+              << bufferCount << " records)" << std::endl
+              << "GPRecordBuffer + copy:   " << bufferCopyMs << " ms" << std::endl;
+
+    if (originalCount != bufferCount)
+    {
+        std::cerr << "Error: record counts differ" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,154 @@
+// Benchmark: parsing Open Gaze API <REC /> records.
+// Compares the std::regex based parsing previously used by
+// GazepointGP3Collector with GazepointRecordParser.
+//
+// Usage: GazepointRecordParser_bench [capture file]
+// The capture file should contain records from Gazepoint Control, one per
+// line. If no file is given, 60 seconds of 150 Hz data is generated.
+
+#include "../GazepointRecordParser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const int passes = 5;
+
+    std::vector<std::string> loadCapture(const char *path)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            throw std::runtime_error(std::string("Could not open ") + path);
+        }
+
+        std::vector<std::string> records;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            records.push_back(line);
+        }
+        return records;
+    }
+
+    std::vector<std::string> generateCapture(unsigned int seconds, unsigned int rate)
+    {
+        std::vector<std::string> records;
+        for (unsigned int i = 0; i < seconds * rate; ++i)
+        {
+            std::ostringstream out;
+            out << "<REC CNT=\"" << 100000 + i << "\""
+                << " LPOGX=\"0." << 40000 + (i * 7) % 20000 << "\" LPOGY=\"0.51234\" LPOGV=\"1\""
+                << " RPOGX=\"0." << 41000 + (i * 3) % 20000 << "\" RPOGY=\"0.49876\" RPOGV=\"" << (i % 50 != 0) << "\" />";
+            records.push_back(out.str());
+        }
+        return records;
+    }
+
+    // the parsing GazepointGP3Collector used before GazepointRecordParser
+    bool parseRegex(const std::string &rxstr, double &checksum)
+    {
+        static const std::regex r(
+            "^<REC CNT=\"(\\d+)\" LPOGX=\"([01]\\.\\d+)\" LPOGY=\"([01]\\.\\d+)\" LPOGV=\"([01])\" RPOGX=\"([01]\\.\\d+)\" RPOGY=\"([01]\\.\\d+)\" RPOGV=\"([01])\" />$");
+        std::smatch matches;
+
+        if (!std::regex_match(rxstr, matches, r))
+        {
+            return false;
+        }
+
+        double id = std::stod(matches[1]);
+        double xLeft = std::stod(matches[2]);
+        double yLeft = std::stod(matches[3]);
+        bool validLeft = (std::string(matches[4])[0] == '1' ? true : false);
+        double xRight = std::stod(matches[5]);
+        double yRight = std::stod(matches[6]);
+        bool validRight = (std::string(matches[7])[0] == '1' ? true : false);
+
+        checksum += id + xLeft + yLeft + xRight + yRight + validLeft + validRight;
+        return true;
+    }
+
+    template <typename F>
+    double bestOf(F func)
+    {
+        double best = 1e30;
+        for (int i = 0; i < passes; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            func();
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, ms);
+        }
+        return best;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> records;
+    try
+    {
+        records = (argc > 1 ? loadCapture(argv[1]) : generateCapture(60, 150));
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    size_t regexCount = 0, parserCount = 0;
+    double regexChecksum = 0.0, parserChecksum = 0.0;
+
+    double regexMs = bestOf([&]() {
+        regexCount = 0;
+        regexChecksum = 0.0;
+        for (const std::string &r : records)
+        {
+            regexCount += parseRegex(r, regexChecksum);
+        }
+    });
+
+    unsigned long long errors = 0;
+    double parserMs = bestOf([&]() {
+        GazepointRecordParser parser;
+        GazepointRecord rec;
+        parserCount = 0;
+        parserChecksum = 0.0;
+        for (const std::string &r : records)
+        {
+            if (parser.parse(r, rec) == GazepointRecordParser::RESULT_OK)
+            {
+                ++parserCount;
+                parserChecksum += rec.cnt + rec.lpogx + rec.lpogy + rec.rpogx
+                                  + rec.rpogy + rec.lpogv + rec.rpogv;
+            }
+        }
+        errors = parser.getErrorCount();
+    });
+
+    const double n = static_cast<double>(records.size());
+    std::cout << "Records: " << records.size() << std::endl
+              << "std::regex:            " << regexMs << " ms ("
+              << regexMs * 1e6 / n << " ns/record, " << regexCount
+              << " matched)" << std::endl
+              << "GazepointRecordParser: " << parserMs << " ms ("
+              << parserMs * 1e6 / n << " ns/record, " << parserCount
+              << " parsed, " << errors << " errors)" << std::endl
+              << "Checksums: " << regexChecksum << " / " << parserChecksum
+              << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+// Benchmark: a whole validation session, end to end, with the headless UI.
+// Each target is clicked as soon as it has been "drawn", with the synthetic
+// tracker running, and every measurement is written to a data file, so this
+// covers everything from picking targets to writing the output.
+//
+// Usage: ValidatorSession_bench [cols] [rows] [repeats]
+// No display is needed.
+
+#include "../Validator.h"
+#include "../ValidatorConfig.h"
+#include "../ValidatorUIHeadless.h"
+#include "../test/TempFile.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+    const unsigned int cols = (argc > 1 ? std::stoul(argv[1]) : 20);
+    const unsigned int rows = (argc > 2 ? std::stoul(argv[2]) : 20);
+    const unsigned int repeats = (argc > 3 ? std::stoul(argv[3]) : 10);
+
+    ValidatorConfig config(cols, rows, repeats);
+    config.tracker = "synthetic";
+    config.headless = true;
+
+    // the validator's own output goes here while it runs
+    std::ostringstream sink;
+    std::streambuf *coutBuf = std::cout.rdbuf();
+
+    double sessionMs = 0.0;
+    std::uint64_t clicks = 0, frames = 0, ticks = 0, simulatedMs = 0;
+    try
+    {
+        // the output, and the summary written alongside it
+        TempFile output;
+        output.sibling(".summary.csv");
+        config.outputFile = output.getPath();
+
+        // created first, so the tracker sees the UI's resolution
+        ValidatorUIHeadless *ui = new ValidatorUIHeadless(config.targetSize, config.targType,
+                                                          ValidatorUIHeadless::defaultResolution);
+
+        std::cout.rdbuf(sink.rdbuf());
+        Validator v(config);
+        v.startTrackerDataCollector();
+
+        auto start = std::chrono::steady_clock::now();
+        v.startUI(ui); // returns when every target is done
+        sessionMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        clicks = ui->getClickCount();
+        frames = ui->getFrameCount();
+        ticks = ui->getTickCount();
+        simulatedMs = ui->getSimulatedTime();
+
+        v.stopTrackerDataCollector();
+        std::cout.rdbuf(coutBuf);
+    }
+    catch (const std::exception &e)
+    {
+        std::cout.rdbuf(coutBuf);
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const unsigned int measurements = cols * rows * repeats;
+    std::cout << "Grid: " << cols << "x" << rows << " x " << repeats << " repeats ("
+              << measurements << " measurements)" << std::endl
+              << "Clicks: " << clicks << ", frames: " << frames
+              << ", timer ticks: " << ticks << std::endl
+              << "Simulated session time: " << simulatedMs / 1000.0 << " s" << std::endl
+              << "Session time:           " << sessionMs << " ms" << std::endl
+              << "Per measurement:        " << sessionMs * 1000.0 / measurements << " us"
+              << std::endl;
+
+    // the measurement queue's statistics, from the validator's output
+    std::istringstream lines(sink.str());
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        if (line.compare(0, 7, "Output:") == 0)
+        {
+            std::cout << line << std::endl;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
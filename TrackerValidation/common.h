@@ -21,6 +21,8 @@ constexpr double pi = 3.14159265358979323846264338327950288419716939937510582097
 constexpr unsigned int invalidCoord = INT_MAX;
 
 // get the resolution of the current screen
+// note: this asks the windowing system every time, which is slow. Use
+//       DisplayGeometry::getResolution() for the cached value.
 std::pair<unsigned int, unsigned int> getScreenRes();
 
 } // end namespace common
@@ -1,12 +1,20 @@
 // Dummy methods for the eyelink system. These will be used if the
 // eyelink_core64 lib is not present to allow the system to compile. If these
 // dummy methods are used, connecting to the eyelink will not work.
+//
+// Opening the connection in dummy mode (open_eyelink_connection(1)) will
+// generate a synthetic 2000 Hz binocular sample stream instead, so the
+// collector can be tested without any hardware.
 
 #include "core_expt.h"
 #include "eyelink.h"
 
-#include <stdexcept>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <thread>
 
 namespace
 {
@@ -26,19 +34,119 @@ namespace
                   << "Note: this eye tracker is currently only supported under Windows."
                   << std::endl;
     }
+
+    // synthetic sample stream used in dummy mode
+    const unsigned int dummySampleRate = 2000; // Hz
+
+    bool dummyMode = false;
+    std::chrono::steady_clock::time_point dummyStart;
+    unsigned long long dummyNext = 0;  // index of the next sample to read
+    FSAMPLE dummySample;
+
+    std::chrono::steady_clock::time_point dummySampleTime(unsigned long long n)
+    {
+        return dummyStart
+               + std::chrono::microseconds(n * 1000000ULL / dummySampleRate);
+    }
+
+    // number of samples which are due at the current time
+    unsigned long long dummySamplesDue()
+    {
+        std::chrono::microseconds elapsed
+            = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - dummyStart);
+        return static_cast<unsigned long long>(elapsed.count())
+               * dummySampleRate / 1000000ULL + 1;
+    }
+
+    void dummyMakeSample(unsigned long long n)
+    {
+        std::memset(&dummySample, 0, sizeof(dummySample));
+
+        // time is in ms, with the half ms flagged by SAMPLE_ADD_OFFSET
+        dummySample.time = static_cast<UINT32>(n * 1000ULL / dummySampleRate);
+        dummySample.type = SAMPLE_TYPE;
+        dummySample.flags = SAMPLE_LEFT | SAMPLE_RIGHT | SAMPLE_GAZEXY;
+        if ((n * 1000ULL) % dummySampleRate != 0)
+        {
+            dummySample.flags |= SAMPLE_ADD_OFFSET;
+        }
+
+        // slow movement around the point the old dummy data used
+        double t = static_cast<double>(n) / dummySampleRate;
+        float dx = static_cast<float>(20.0 * std::sin(t));
+        float dy = static_cast<float>(20.0 * std::cos(t * 0.7));
+
+        dummySample.gx[LEFT_EYE] = 880.0f + dx;
+        dummySample.gy[LEFT_EYE] = 421.0f + dy;
+        dummySample.gx[RIGHT_EYE] = 882.0f + dx;
+        dummySample.gy[RIGHT_EYE] = 420.0f + dy;
+    }
 }
 
 void ELCALLTYPE close_eyelink_system(void)
 {
+    if (::dummyMode)
+    {
+        ::dummyMode = false;
+        return;
+    }
+
     ::eyelinkInstructions();
 }
 
 INT16 ELCALLTYPE eyecmd_printf(const char *, ...)
 {
+    if (::dummyMode)
+    {
+        return 0;
+    }
+
     ::eyelinkInstructions();
     return -1;
 }
 
+INT16 ELCALLTYPE eyelink_get_next_data(void FARTYPE *buf)
+{
+    if (!::dummyMode)
+    {
+        ::eyelinkInstructions();
+        return 0;
+    }
+
+    unsigned long long due = ::dummySamplesDue();
+    if (::dummyNext >= due)
+    {
+        return 0;
+    }
+
+    // like the real link queue, drop the oldest data if we fall too far behind
+    if (due - ::dummyNext > ::dummySampleRate)
+    {
+        ::dummyNext = due - ::dummySampleRate;
+    }
+
+    ::dummyMakeSample(::dummyNext++);
+    if (buf != nullptr)
+    {
+        std::memcpy(buf, &::dummySample, sizeof(::dummySample));
+    }
+
+    return SAMPLE_TYPE;
+}
+
+INT16 ELCALLTYPE eyelink_get_float_data(void FARTYPE *buf)
+{
+    if (!::dummyMode)
+    {
+        ::eyelinkInstructions();
+        return 0;
+    }
+
+    std::memcpy(buf, &::dummySample, sizeof(::dummySample));
+    return SAMPLE_TYPE;
+}
+
 INT16 ELCALLTYPE eyelink_newest_sample(void FARTYPE *)
 {
     ::eyelinkInstructions();
@@ -53,29 +161,73 @@ INT16 ELCALLTYPE eyelink_position_prescaler(void)
 
 INT16 ELCALLTYPE eyelink_wait_for_block_start(UINT32, INT16, INT16)
 {
+    if (::dummyMode)
+    {
+        return 1;
+    }
+
     ::eyelinkInstructions();
     return -1;
 }
 
-INT16 ELCALLTYPE open_eyelink_connection(INT16)
+INT16 ELCALLTYPE eyelink_wait_for_data(UINT32 maxwait, INT16 samples, INT16)
 {
-    ::eyelinkInstructions();
-    return -1;
+    if (!::dummyMode || !samples)
+    {
+        ::eyelinkInstructions();
+        return 0;
+    }
+
+    // sleep until the next sample is due, or the timeout
+    std::chrono::steady_clock::time_point timeout
+        = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxwait);
+    std::chrono::steady_clock::time_point next = ::dummySampleTime(::dummyNext);
+    std::this_thread::sleep_until(next < timeout ? next : timeout);
+
+    return (::dummyNext < ::dummySamplesDue() ? 1 : 0);
 }
 
-INT16 ELCALLTYPE set_eyelink_address(char *addr)
+INT16 ELCALLTYPE open_eyelink_connection(INT16 mode)
 {
+    if (mode == 1)
+    {
+        std::cerr << "Eyelink libraries have not been loaded - using "
+                  << "synthetic " << ::dummySampleRate << " Hz dummy data."
+                  << std::endl;
+        ::dummyMode = true;
+        return 0;
+    }
+
     ::eyelinkInstructions();
     return -1;
 }
 
+INT16 ELCALLTYPE set_eyelink_address(char *)
+{
+    // the address isn't used in dummy mode, and any error will be reported
+    // when we try to open the connection
+    return 0;
+}
+
 INT16 ELCALLTYPE start_recording(INT16, INT16, INT16, INT16)
 {
+    if (::dummyMode)
+    {
+        ::dummyStart = std::chrono::steady_clock::now();
+        ::dummyNext = 0;
+        return 0;
+    }
+
     ::eyelinkInstructions();
     return -1;
 }
 
 void ELCALLTYPE stop_recording(void)
 {
+    if (::dummyMode)
+    {
+        return;
+    }
+
     ::eyelinkInstructions();
 }
@@ -10,6 +10,7 @@
 //////////////////////////////////////////////////////////////////////////////////////
 
 #include "GPClient.h"
+#include "GPRecordBuffer.h"
 
 #include <thread>
 #include <chrono>
@@ -26,12 +27,20 @@
     #include <sys/socket.h>
     #include <netinet/in.h>
     #include <arpa/inet.h>
+    #include <cerrno>
     #define SOCKADDR_IN sockaddr_in
     #define SOCKET int
     #define INVALID_SOCKET -1
     #define SOCKET_ERROR -1
 #endif
 
+#ifdef __linux__
+    // event driven receive loop - see GPClientThread
+    #include <cstdint>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+#endif
+
 #define RX_TCP_BUFFER_MAX 64000
 
 #pragma comment(lib, "Ws2_32.lib")
@@ -51,11 +60,40 @@ GPClient::GPClient(std::string ip_address, unsigned int ip_port)
   _rx_buffer_size = 60*60*3;
   _rx_status = false;
   _connected_status = false;
+  _thread_exit = false;
+  _latency = GPLatencyStats{0, 0.0, 0.0, 0.0};
+
+#ifdef __linux__
+  _wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+  _wake_fd = -1;
+#endif
 }
 
 GPClient::~GPClient(void)
 {
   client_disconnect();
+
+#ifdef __linux__
+  if (_wake_fd != -1)
+  {
+    close(_wake_fd);
+  }
+#endif
+}
+
+void GPClient::wake_thread()
+{
+#ifdef __linux__
+  if (_wake_fd != -1)
+  {
+    uint64_t one = 1;
+    if (write(_wake_fd, &one, sizeof(one)) != sizeof(one))
+    {
+      // counter is already non-zero, so the thread will wake anyway
+    }
+  }
+#endif
 }
 
 void GPClient::client_connect ()
@@ -76,6 +114,7 @@ void GPClient::client_disconnect ()
   _rx_mutex.lock();
   _thread_exit = TRUE;
   _rx_mutex.unlock();
+  wake_thread();
 
   std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
@@ -88,9 +127,8 @@ void GPClient::client_disconnect ()
 unsigned int GPClient::GPClientThread (GPClient *ptr)
 {
   unsigned int result;
-  unsigned int delimiter_index;
-  std::string rxstr;
-  char rxbuffer [RX_TCP_BUFFER_MAX];
+  GPRecordBuffer rx_records(2 * RX_TCP_BUFFER_MAX);
+  std::string_view record;
   // int state = 0; FIXME this is never used
   unsigned long rx_time = getTickCount();
 
@@ -136,6 +174,8 @@ unsigned int GPClient::GPClientThread (GPClient *ptr)
   {
 #ifdef _WIN32
     if (WSAGetLastError() != WSAEWOULDBLOCK)
+#else
+    if (errno != EINPROGRESS)
 #endif
     {
       std::cerr << "Error connecting to gazepoint at "
@@ -145,7 +185,43 @@ unsigned int GPClient::GPClientThread (GPClient *ptr)
     }
   }
 
-#ifdef _WIN32
+#ifdef __linux__
+  // non-blocking socket - wait for the socket to become writable, which is
+  // when the connection has either completed or failed
+  int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  {
+    struct epoll_event ev = {};
+    ev.events = EPOLLOUT;
+    ev.data.fd = ipsocket;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ipsocket, &ev);
+
+    int so_error = 0;
+    socklen_t len = sizeof(so_error);
+    if (epoll_wait(epoll_fd, &ev, 1, 2000) != 1
+        || getsockopt(ipsocket, SOL_SOCKET, SO_ERROR, &so_error, &len) != 0
+        || so_error != 0)
+    {
+        std::cerr << "Error connecting to gazepoint at "
+            << ptr->_ip_address << ":" << ptr->_ip_port << std::endl
+            << "Is Gazepoint Control running?" << std::endl;
+        throw std::runtime_error("Gazepoint connection error");
+    }
+
+    // from now on we only care about incoming data (or the peer closing)
+    // and the wakeup eventfd
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, ipsocket, &ev);
+
+    if (ptr->_wake_fd != -1)
+    {
+      struct epoll_event wake_ev = {};
+      wake_ev.events = EPOLLIN;
+      wake_ev.data.fd = ptr->_wake_fd;
+      epoll_ctl(epoll_fd, EPOLL_CTL_ADD, ptr->_wake_fd, &wake_ev);
+    }
+  }
+  bool socket_open = true;
+#elif defined _WIN32
   // non-blocking socket - wait to make sure it connects
   {
     fd_set set;
@@ -173,7 +249,34 @@ unsigned int GPClient::GPClientThread (GPClient *ptr)
 
   do
   {
-    auto end_time = std::chrono::system_clock::now() + std::chrono::milliseconds(5);
+#ifdef __linux__
+    // Sleep until the socket has data, a command has been queued or we have
+    // been asked to exit. The timeout is only there to keep _rx_status
+    // up to date when the server goes quiet.
+    struct epoll_event events[2];
+    int num_events = epoll_wait(epoll_fd, events, 2, 1000);
+
+    for (int i = 0; i < num_events; ++i)
+    {
+      if (events[i].data.fd == ptr->_wake_fd)
+      {
+        uint64_t count;
+        if (read(ptr->_wake_fd, &count, sizeof(count)) != sizeof(count))
+        {
+          // nothing to drain
+        }
+      }
+      else if (events[i].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+      {
+        // Server has gone away. Stop watching the socket or epoll would
+        // report it as readable forever; any remaining data is read below.
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, ipsocket, nullptr);
+        socket_open = false;
+      }
+    }
+#endif
+    auto wake_time = std::chrono::steady_clock::now();
+    bool dispatched = false;
 
     // if data is not received within last 4 second then rx is not active
     if (getTickCount() > rx_time + 4000)
@@ -185,7 +288,9 @@ unsigned int GPClient::GPClientThread (GPClient *ptr)
     {
     do
     {
-        result = recv(ipsocket, rxbuffer, RX_TCP_BUFFER_MAX, 0);
+        // receive straight into the record buffer - no copying
+        char *rx_ptr = rx_records.write_ptr();
+        result = recv(ipsocket, rx_ptr, static_cast<int>(rx_records.write_space()), 0);
 
         // FIXME this is never used
         if (result == SOCKET_ERROR)
@@ -198,40 +303,65 @@ unsigned int GPClient::GPClientThread (GPClient *ptr)
             rx_time = getTickCount();
             ptr->_rx_status = TRUE;
 
-            // save room to add a NULL character to incoming char stream
-            if (result > RX_TCP_BUFFER_MAX-1) 
-{
-                result = RX_TCP_BUFFER_MAX-1;
-            }
-
-            rxbuffer[result] = '\0';
-            rxstr = rxstr + rxbuffer;
+            rx_records.commit(result);
 
-            // find end of record delimiter
-            delimiter_index = static_cast<unsigned int>(rxstr.find ("\r\n", 0));
-
-ptr->_rx_mutex.lock();
-            while (delimiter_index != std::string::npos && rxstr != "")
+            if (ptr->_rx_handler)
             {
-                std::string tmp = rxstr.substr(0, delimiter_index);
-
-                // save record at head of queue (FIFO)
-                ptr->_rx_buffer.push_back(tmp);
-
-                // remove records longer than queue size (so we don't run out of memory)
-                while (ptr->_rx_buffer.size() > ptr->_rx_buffer_size)
+                // hand each record straight over as a view into the receive
+                // buffer - no copying or queueing
+                while (rx_records.next_record(record))
                 {
-                    ptr->_rx_buffer.pop_front();
+                    if (!record.empty())
+                    {
+                        ptr->_rx_handler(record);
+                        dispatched = true;
+                    }
                 }
-
-rxstr.erase(0, delimiter_index+2);
-                delimiter_index = static_cast<unsigned int>(rxstr.find ("\r\n", 0));
             }
-          ptr->_rx_mutex.unlock();
+            else
+            {
+                ptr->_rx_mutex.lock();
+                while (rx_records.next_record(record))
+                {
+                    if (record.empty())
+                    {
+                        continue;
+                    }
+
+                    // save record at head of queue (FIFO)
+                    ptr->_rx_buffer.emplace_back(record);
+                    dispatched = true;
+
+                    // remove records longer than queue size (so we don't run out of memory)
+                    while (ptr->_rx_buffer.size() > ptr->_rx_buffer_size)
+                    {
+                        ptr->_rx_buffer.pop_front();
+                    }
+                }
+                ptr->_rx_mutex.unlock();
+            }
         }
       }
       while (result > 0 && result != SOCKET_ERROR && ptr->_thread_exit  != TRUE);
 
+      if (dispatched)
+      {
+        // how long between waking up and the records being available?
+        double latency_us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - wake_time).count();
+
+        ptr->_rx_mutex.lock();
+        GPLatencyStats &stats = ptr->_latency;
+        ++stats.count;
+        stats.last_us = latency_us;
+        stats.mean_us += (latency_us - stats.mean_us) / static_cast<double>(stats.count);
+        if (latency_us > stats.max_us)
+        {
+          stats.max_us = latency_us;
+        }
+        ptr->_rx_mutex.unlock();
+      }
+
       ptr->_tx_mutex.lock();
       for (unsigned int i = 0; i < ptr->_tx_buffer.size(); i++)
       {
@@ -249,7 +379,14 @@ rxstr.erase(0, delimiter_index+2);
       ptr->_tx_mutex.unlock();
     }
 
+#ifdef __linux__
+    if (!socket_open)
+    {
+      ptr->_connected_status = FALSE;
+    }
+#else
     std::this_thread::sleep_for(std::chrono::milliseconds(5));
+#endif
   }
   while (ptr->_thread_exit  != TRUE);
 
@@ -259,6 +396,9 @@ rxstr.erase(0, delimiter_index+2);
 #else
   close(ipsocket);
 #endif
+#ifdef __linux__
+  close(epoll_fd);
+#endif
 
   ptr->_connected_status = FALSE;
 
@@ -269,9 +409,11 @@ void GPClient::send_cmd(std::string cmd)
 {
   cmd = cmd + "\r\n";
  
-  _rx_mutex.lock();
+  _tx_mutex.lock();
   _tx_buffer.push_back (cmd);
-  _rx_mutex.unlock();
+  _tx_mutex.unlock();
+
+  wake_thread();
 }
 
 std::string GPClient::get_rx_latest()
@@ -297,6 +439,12 @@ void GPClient::get_rx(std::deque <std::string> &data)
   _rx_mutex.unlock();
 }
 
+GPLatencyStats GPClient::get_dispatch_latency()
+{
+  std::lock_guard<std::mutex> lock(_rx_mutex);
+  return _latency;
+}
+
 bool GPClient::get_rx_status()
 {
   return _rx_status;
@@ -15,6 +15,18 @@
 #include <vector>
 #include <deque>
 #include <mutex>
+#include <functional>
+#include <string_view>
+
+// Time taken between the receive thread waking up and the received records
+// being available to readers (in microseconds).
+struct GPLatencyStats
+{
+  unsigned long long count;
+  double last_us;
+  double mean_us;
+  double max_us;
+};
 
 class GPClient
 {
@@ -29,6 +41,15 @@ private:
   std::mutex _rx_mutex;
   std::mutex _tx_mutex;
   volatile bool _thread_exit;
+
+  // Linux only: eventfd used to wake the receive thread when a command is
+  // queued or we are disconnecting. -1 if not used.
+  int _wake_fd;
+  void wake_thread();
+
+  GPLatencyStats _latency; // protected by _rx_mutex
+
+  std::function<void(std::string_view)> _rx_handler;
   static unsigned int GPClientThread (GPClient *ptr);
 
   bool _keep_all_data;
@@ -45,8 +66,10 @@ public:
   void send_cmd(std::string cmd);
 
   void set_rx_buffer_max(unsigned int max) {_rx_buffer_size = max;} // set maximum records to hold in internal buffer
+  void set_rx_handler(std::function<void(std::string_view)> handler) {_rx_handler = handler;} // call handler on the receive thread for every record instead of buffering it (set before connecting)
   std::string get_rx_latest(); // get latest record and clear buffer
   void get_rx(std::deque <std::string> &data); // get all records and clear buffer
+  GPLatencyStats get_dispatch_latency(); // receive thread wakeup-to-dispatch latency
   bool get_rx_status(); // query if server has sent any data recently (connection may be closed from server side)?
   bool is_connected(); // query if connected to server
 };
@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// GPRecordBuffer.cpp - Fixed capacity receive buffer which splits the Open Gaze API
+// byte stream into "\r\n" delimited records.
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "GPRecordBuffer.h"
+
+#include <cstring>
+
+GPRecordBuffer::GPRecordBuffer(size_t capacity)
+  : _buffer(capacity < 2 ? 2 : capacity), _start(0), _scan(0), _end(0),
+    _overflow_count(0)
+{ }
+
+void GPRecordBuffer::compact()
+{
+  if (_start == 0)
+  {
+    return;
+  }
+
+  size_t remaining = _end - _start;
+  if (remaining > 0)
+  {
+    std::memmove(_buffer.data(), _buffer.data() + _start, remaining);
+  }
+
+  _scan -= _start;
+  _end = remaining;
+  _start = 0;
+}
+
+char *GPRecordBuffer::write_ptr()
+{
+  // Only compact when we are running low on space. By then most of the
+  // buffer has been handed out as records, so only a partial record is moved.
+  if (_end - _start == 0)
+  {
+    _start = _scan = _end = 0;
+  }
+  else if (write_space() < _buffer.size() / 2)
+  {
+    compact();
+  }
+
+  if (write_space() == 0)
+  {
+    // a single record has filled the whole buffer - this isn't valid data,
+    // so throw it away and start again
+    ++_overflow_count;
+    clear();
+  }
+
+  return _buffer.data() + _end;
+}
+
+size_t GPRecordBuffer::write_space() const
+{
+  return _buffer.size() - _end;
+}
+
+void GPRecordBuffer::commit(size_t n)
+{
+  if (n > write_space())
+  {
+    n = write_space();
+  }
+
+  _end += n;
+}
+
+bool GPRecordBuffer::next_record(std::string_view &record)
+{
+  if (_scan >= _end)
+  {
+    return false;
+  }
+
+  const char *base = _buffer.data();
+  const char *nl = static_cast<const char *>(
+      std::memchr(base + _scan, '\n', _end - _scan));
+
+  if (nl == nullptr)
+  {
+    // no delimiter yet - next time only look at new data
+    _scan = _end;
+    return false;
+  }
+
+  size_t delim = static_cast<size_t>(nl - base);
+  size_t record_end = delim;
+  if (record_end > _start && base[record_end - 1] == '\r')
+  {
+    --record_end;
+  }
+
+  record = std::string_view(base + _start, record_end - _start);
+
+  _start = delim + 1;
+  _scan = _start;
+
+  return true;
+}
+
+void GPRecordBuffer::clear()
+{
+  _start = _scan = _end = 0;
+}
+
+size_t GPRecordBuffer::pending() const
+{
+  return _end - _start;
+}
+
+unsigned long long GPRecordBuffer::overflow_count() const
+{
+  return _overflow_count;
+}
@@ -0,0 +1,60 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// GPRecordBuffer.h - Fixed capacity receive buffer which splits the Open Gaze API
+// byte stream into "\r\n" delimited records.
+//
+// Data is received straight into the buffer (no intermediate string), and the
+// delimiter scan resumes where it left off, so each byte is looked at once.
+// Records are handed out as std::string_view into the buffer without copying.
+// Rather than wrapping around like a classic ring, the (small) partial record
+// at the end is moved to the front when space runs out, which keeps every
+// record contiguous.
+//////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+class GPRecordBuffer
+{
+private:
+  std::vector<char> _buffer; // allocated once, never resized
+
+  size_t _start; // start of the first record not yet handed out
+  size_t _scan;  // where the delimiter search resumes
+  size_t _end;   // end of received data
+
+  unsigned long long _overflow_count;
+
+  // move the partial record at _start to the front of the buffer
+  void compact();
+
+public:
+  explicit GPRecordBuffer(size_t capacity = 128000);
+
+  // Where to write received data, and how much room there is. This may move
+  // unconsumed data, so any views from next_record() are invalidated.
+  // If a single record fills the whole buffer it is discarded and counted
+  // as an overflow.
+  char *write_ptr();
+  size_t write_space() const;
+
+  // mark n bytes at write_ptr() as received
+  void commit(size_t n);
+
+  // Get the next complete record (without the delimiter). The view is valid
+  // until the next call to write_ptr() or clear().
+  // A lone "\n" is also accepted as a delimiter.
+  // @returns false if no complete record is available
+  bool next_record(std::string_view &record);
+
+  // discard everything
+  void clear();
+
+  // bytes received which are not yet part of a complete record
+  size_t pending() const;
+
+  // number of times a record was too long to fit in the buffer
+  unsigned long long overflow_count() const;
+};
@@ -0,0 +1,540 @@
+//////////////////////////////////////////////////////////////////////////////////////
+// GPServer.cpp - Local stand-in for the Gazepoint Control Open Gaze API server.
+//
+// Speaks enough of the Open Gaze API to drive GPClient and GazepointGP3Collector
+// without a tracker: <SET ID=... /> and <GET ID=... /> commands are ACKed, and
+// once ENABLE_SEND_DATA is set, <REC /> records are streamed at a configurable
+// rate. Records can be sent in bursts with random jitter to mimic a busy
+// network, or replayed from a capture of a real Gazepoint stream.
+//
+// Usage: GPServer [options]
+//   --port=<n>       TCP port to listen on (default 4242)
+//   --rate=<n>       records per second (default 150)
+//   --burst=<n>      records sent together in one write (default 1)
+//   --jitter=<ms>    random delay of up to this long added to each write (default 0)
+//   --replay=<file>  send the records in this capture (one per line) on a loop.
+//                    If the records have a TIME attribute they are sent with the
+//                    original timing, otherwise at --rate.
+//   --duration=<s>   stop after this many seconds of streaming (default 0 = forever)
+//
+// One client is served at a time. When the client disconnects the server waits
+// for the next one.
+//////////////////////////////////////////////////////////////////////////////////////
+
+#include "GPRecordBuffer.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #define CLOSE_SOCKET closesocket
+    #define SEND_FLAGS 0
+    typedef int socklen_t;
+#else
+    #include <unistd.h>
+    #include <sys/select.h>
+    #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #define SOCKADDR_IN sockaddr_in
+    #define SOCKET int
+    #define INVALID_SOCKET -1
+    #define SOCKET_ERROR -1
+    #define CLOSE_SOCKET close
+    // don't raise SIGPIPE when the client goes away
+    #define SEND_FLAGS MSG_NOSIGNAL
+#endif
+
+#pragma comment(lib, "Ws2_32.lib")
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    struct ServerConfig
+    {
+        unsigned int port = 4242;
+        double rate = 150.0;
+        unsigned int burst = 1;
+        double jitterMs = 0.0;
+        std::string replayFile;
+        double duration = 0.0;
+    };
+
+    // A record to send, and when to send it (seconds from the start of the
+    // stream). Replayed records are sent verbatim.
+    struct Record
+    {
+        double time;
+        std::string text;
+    };
+
+    // Get the value of attribute name="value" from a command or record.
+    bool getAttribute(std::string_view text, std::string_view name,
+                      std::string &value)
+    {
+        size_t pos = 0;
+        while ((pos = text.find(name, pos)) != std::string_view::npos)
+        {
+            // must be a whole attribute name followed by ="
+            bool start = (pos == 0 || text[pos - 1] == ' ');
+            size_t quote = pos + name.size();
+            if (start && text.substr(quote, 2) == "=\"")
+            {
+                size_t end = text.find('"', quote + 2);
+                if (end == std::string_view::npos)
+                {
+                    return false;
+                }
+
+                value = std::string(text.substr(quote + 2, end - quote - 2));
+                return true;
+            }
+            pos = quote;
+        }
+        return false;
+    }
+
+    std::vector<Record> loadReplay(const std::string &path, double rate)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            throw std::runtime_error("Could not open " + path);
+        }
+
+        std::vector<Record> records;
+        std::string line, time;
+        bool allTimed = true;
+        while (std::getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+
+            // only replay data - ACKs were replies to the original client
+            if (line.compare(0, 4, "<REC") != 0)
+            {
+                continue;
+            }
+
+            Record rec;
+            rec.text = line;
+            rec.time = 0.0;
+            if (getAttribute(line, "TIME", time))
+            {
+                rec.time = std::atof(time.c_str());
+            }
+            else
+            {
+                allTimed = false;
+            }
+            records.push_back(rec);
+        }
+
+        if (records.empty())
+        {
+            throw std::runtime_error("No <REC /> records in " + path);
+        }
+
+        // use the original timing if we can, relative to the first record
+        double first = records.front().time;
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            records[i].time = (allTimed ? records[i].time - first : i / rate);
+        }
+
+        return records;
+    }
+
+    // State of one client connection.
+    class Session
+    {
+      private:
+        SOCKET sock;
+        const ServerConfig &config;
+        const std::vector<Record> &replay;
+
+        GPRecordBuffer rxBuffer;
+
+        // SET values received, e.g. ENABLE_SEND_DATA -> 1
+        std::map<std::string, std::string> settings;
+
+        std::mt19937 rng;
+        std::uniform_real_distribution<double> jitter;
+
+        bool open;
+        bool streaming;
+        Clock::time_point streamStart;
+        unsigned long long sent;
+
+        bool enabled(const std::string &id)
+        {
+            return settings[id] == "1";
+        }
+
+        void sendText(const std::string &text)
+        {
+            size_t done = 0;
+            while (done < text.size())
+            {
+                int result = send(sock, text.data() + done,
+                                  static_cast<int>(text.size() - done), SEND_FLAGS);
+                if (result <= 0)
+                {
+                    open = false;
+                    return;
+                }
+                done += static_cast<size_t>(result);
+            }
+        }
+
+        void handleCommand(std::string_view cmd)
+        {
+            std::string id, state;
+            if (!getAttribute(cmd, "ID", id))
+            {
+                return;
+            }
+
+            std::ostringstream ack;
+            ack << "<ACK ID=\"" << id << "\"";
+            if (cmd.compare(0, 4, "<SET") == 0)
+            {
+                if (getAttribute(cmd, "STATE", state))
+                {
+                    settings[id] = state;
+                    ack << " STATE=\"" << state << "\"";
+                }
+                else if (id == "SCREEN_SIZE")
+                {
+                    // echo the screen geometry back
+                    static const char * const keys[] = { "X", "Y", "WIDTH", "HEIGHT" };
+                    std::string value;
+                    for (const char *key : keys)
+                    {
+                        if (getAttribute(cmd, key, value))
+                        {
+                            ack << " " << key << "=\"" << value << "\"";
+                        }
+                    }
+                }
+            }
+            else if (cmd.compare(0, 4, "<GET") == 0)
+            {
+                ack << " STATE=\"" << (enabled(id) ? "1" : "0") << "\"";
+            }
+            else
+            {
+                return;
+            }
+            ack << " />\r\n";
+            sendText(ack.str());
+
+            if (id == "ENABLE_SEND_DATA")
+            {
+                bool wasStreaming = streaming;
+                streaming = enabled(id);
+                if (streaming && !wasStreaming)
+                {
+                    streamStart = Clock::now();
+                    sent = 0;
+                }
+            }
+        }
+
+        // time (from the start of the stream) that record n is due
+        double recordTime(unsigned long long n) const
+        {
+            if (replay.empty())
+            {
+                return n / config.rate;
+            }
+
+            // loop the capture, leaving one sample gap between loops
+            const Record &last = replay.back();
+            double loopLength = last.time + 1.0 / config.rate;
+            return (n / replay.size()) * loopLength + replay[n % replay.size()].time;
+        }
+
+        std::string makeRecord(unsigned long long n)
+        {
+            if (!replay.empty())
+            {
+                return replay[n % replay.size()].text + "\r\n";
+            }
+
+            // slow circle around the middle of the screen
+            double t = recordTime(n);
+            double x = 0.5 + 0.2 * std::cos(t);
+            double y = 0.5 + 0.2 * std::sin(t);
+
+            std::ostringstream rec;
+            rec.precision(5);
+            rec << std::fixed << "<REC";
+            if (enabled("ENABLE_SEND_COUNTER"))
+            {
+                rec << " CNT=\"" << n << "\"";
+            }
+            if (enabled("ENABLE_SEND_TIME"))
+            {
+                rec << " TIME=\"" << t << "\"";
+            }
+            if (enabled("ENABLE_SEND_POG_LEFT"))
+            {
+                rec << " LPOGX=\"" << x - 0.002 << "\" LPOGY=\"" << y
+                    << "\" LPOGV=\"1\"";
+            }
+            if (enabled("ENABLE_SEND_POG_RIGHT"))
+            {
+                rec << " RPOGX=\"" << x + 0.002 << "\" RPOGY=\"" << y
+                    << "\" RPOGV=\"1\"";
+            }
+            if (enabled("ENABLE_SEND_POG_BEST"))
+            {
+                rec << " BPOGX=\"" << x << "\" BPOGY=\"" << y << "\" BPOGV=\"1\"";
+            }
+            rec << " />\r\n";
+            return rec.str();
+        }
+
+        // when the next burst should go out, including jitter
+        Clock::time_point nextSendTime()
+        {
+            double due = recordTime(sent + config.burst - 1) + jitter(rng) / 1000.0;
+            return streamStart + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(due));
+        }
+
+      public:
+        Session(SOCKET sock, const ServerConfig &config,
+                const std::vector<Record> &replay)
+            : sock(sock), config(config), replay(replay), rxBuffer(16000),
+              rng(std::random_device()()), jitter(0.0, config.jitterMs),
+              open(true), streaming(false), sent(0)
+        {}
+
+        // serve the client until it disconnects
+        // @returns false if the stream duration has been reached
+        bool run()
+        {
+            Clock::time_point sendAt = Clock::now();
+            while (open)
+            {
+                if (streaming && config.duration > 0.0
+                    && Clock::now() - streamStart > std::chrono::duration<double>(config.duration))
+                {
+                    return false;
+                }
+
+                // wait for a command, or until the next burst is due
+                long waitUs = 100000;
+                if (streaming)
+                {
+                    auto until = std::chrono::duration_cast<std::chrono::microseconds>(
+                        sendAt - Clock::now()).count();
+                    waitUs = (until < 0 ? 0 : (until < waitUs ? static_cast<long>(until) : waitUs));
+                }
+
+                fd_set readSet;
+                FD_ZERO(&readSet);
+                FD_SET(sock, &readSet);
+                timeval timeout;
+                timeout.tv_sec = waitUs / 1000000;
+                timeout.tv_usec = waitUs % 1000000;
+
+                int ready = select(static_cast<int>(sock) + 1, &readSet, nullptr, nullptr, &timeout);
+                if (ready == SOCKET_ERROR)
+                {
+                    return true;
+                }
+
+                if (ready > 0)
+                {
+                    int result = recv(sock, rxBuffer.write_ptr(),
+                                      static_cast<int>(rxBuffer.write_space()), 0);
+                    if (result <= 0)
+                    {
+                        // client has gone
+                        return true;
+                    }
+                    rxBuffer.commit(static_cast<size_t>(result));
+
+                    bool wasStreaming = streaming;
+                    std::string_view cmd;
+                    while (rxBuffer.next_record(cmd))
+                    {
+                        handleCommand(cmd);
+                    }
+                    if (streaming && !wasStreaming)
+                    {
+                        sendAt = nextSendTime();
+                    }
+                }
+
+                if (streaming && Clock::now() >= sendAt)
+                {
+                    std::string burst;
+                    for (unsigned int i = 0; i < config.burst; ++i)
+                    {
+                        burst += makeRecord(sent++);
+                    }
+                    sendText(burst);
+                    sendAt = nextSendTime();
+                }
+            }
+            return true;
+        }
+
+        unsigned long long getSentCount() const
+        {
+            return sent;
+        }
+    };
+
+    ServerConfig parseArgs(int argc, char *argv[])
+    {
+        ServerConfig config;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg(argv[i]);
+            size_t equals = arg.find('=');
+            std::string key = arg.substr(0, equals);
+            std::string val = (equals == std::string::npos ? "" : arg.substr(equals + 1));
+
+            if (key == "--port")
+            {
+                config.port = static_cast<unsigned int>(std::atoi(val.c_str()));
+            }
+            else if (key == "--rate")
+            {
+                config.rate = std::atof(val.c_str());
+            }
+            else if (key == "--burst")
+            {
+                config.burst = static_cast<unsigned int>(std::atoi(val.c_str()));
+            }
+            else if (key == "--jitter")
+            {
+                config.jitterMs = std::atof(val.c_str());
+            }
+            else if (key == "--replay")
+            {
+                config.replayFile = val;
+            }
+            else if (key == "--duration")
+            {
+                config.duration = std::atof(val.c_str());
+            }
+            else
+            {
+                throw std::runtime_error("Invalid argument: " + arg);
+            }
+        }
+
+        if (config.port == 0 || config.rate <= 0.0 || config.burst == 0
+            || config.jitterMs < 0.0)
+        {
+            throw std::runtime_error("port, rate and burst must be positive, and jitter must not be negative");
+        }
+
+        return config;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ServerConfig config;
+    std::vector<Record> replay;
+    try
+    {
+        config = parseArgs(argc, argv);
+        if (!config.replayFile.empty())
+        {
+            replay = loadReplay(config.replayFile, config.rate);
+            std::cout << "Replaying " << replay.size() << " records from "
+                      << config.replayFile << std::endl;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+#ifdef _WIN32
+    WSADATA wsadata;
+    if (WSAStartup(0x0101, &wsadata))
+    {
+        std::cerr << "Error: could not start winsock" << std::endl;
+        return EXIT_FAILURE;
+    }
+#endif
+
+    SOCKET listenSock = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenSock == INVALID_SOCKET)
+    {
+        std::cerr << "Error: could not create socket" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int reuse = 1;
+    setsockopt(listenSock, SOL_SOCKET, SO_REUSEADDR,
+               reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+
+    SOCKADDR_IN addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<unsigned short>(config.port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(listenSock, (struct sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR
+        || listen(listenSock, 1) == SOCKET_ERROR)
+    {
+        std::cerr << "Error: could not listen on port " << config.port << std::endl;
+        CLOSE_SOCKET(listenSock);
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Open Gaze API stand-in listening on 127.0.0.1:" << config.port
+              << " (" << config.rate << " Hz, bursts of " << config.burst
+              << ", jitter " << config.jitterMs << " ms)" << std::endl;
+
+    bool keepGoing = true;
+    while (keepGoing)
+    {
+        SOCKET clientSock = accept(listenSock, nullptr, nullptr);
+        if (clientSock == INVALID_SOCKET)
+        {
+            continue;
+        }
+
+        std::cout << "Client connected" << std::endl;
+        Session session(clientSock, config, replay);
+        keepGoing = session.run();
+        CLOSE_SOCKET(clientSock);
+        std::cout << "Client disconnected after " << session.getSentCount()
+                  << " records" << std::endl;
+    }
+
+    CLOSE_SOCKET(listenSock);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+
+    return EXIT_SUCCESS;
+}
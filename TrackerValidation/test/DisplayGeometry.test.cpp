@@ -0,0 +1,46 @@
+#include "../DisplayGeometry.h"
+#include "../OpenGLCommon.h"
+
+#include "catch.hpp"
+
+TEST_CASE("PixelTransform", "[DisplayGeometry]")
+{
+    PixelTransform t(1024, 768);
+
+    // the example from OpenGLPixelToPosition
+    std::pair<double, double> pos = t.toPosition(100, 100);
+    CHECK(pos.first == Approx(-0.8046875));
+    CHECK(pos.second == Approx(0.7395833));
+
+    // corners and centre
+    CHECK(t.toPosition(0, 0) == std::make_pair(-1.0, 1.0));
+    CHECK(t.toPosition(1024, 768) == std::make_pair(1.0, -1.0));
+    CHECK(t.toPosition(512, 384) == std::make_pair(0.0, 0.0));
+
+    // off the screen
+    pos = t.toPosition(-512, 1152);
+    CHECK(pos.first == Approx(-2.0));
+    CHECK(pos.second == Approx(-2.0));
+}
+
+TEST_CASE("DisplayGeometry", "[DisplayGeometry]")
+{
+    DisplayGeometry &geometry = DisplayGeometry::get();
+    CHECK(&geometry == &DisplayGeometry::get());
+
+    geometry.setResolution(std::make_pair(1920, 1080));
+    const std::uint64_t generation = geometry.getGeneration();
+
+    CHECK(geometry.getResolution() == std::pair<unsigned int, unsigned int>(1920, 1080));
+    CHECK(geometry.getPixelTransform().toPosition(960, 540) == std::make_pair(0.0, 0.0));
+    CHECK(OpenGLPixelToPosition(1920, 0) == std::make_pair(1.0, 1.0));
+
+    // setting the same resolution isn't a change
+    geometry.setResolution(std::make_pair(1920, 1080));
+    CHECK(geometry.getGeneration() == generation);
+
+    geometry.setResolution(std::make_pair(800, 600));
+    CHECK(geometry.getGeneration() != generation);
+    CHECK(geometry.getResolution() == std::pair<unsigned int, unsigned int>(800, 600));
+    CHECK(OpenGLPixelToPosition(400, 300) == std::make_pair(0.0, 0.0));
+}
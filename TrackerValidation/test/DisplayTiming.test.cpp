@@ -0,0 +1,70 @@
+#include "../DisplayTiming.h"
+
+#include "catch.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+TEST_CASE("LatencyHistogram", "[DisplayTiming]")
+{
+    LatencyHistogram h(20);
+
+    SECTION("Empty")
+    {
+        CHECK(h.getCount() == 0);
+        CHECK(h.getMean() == 0.0);
+        CHECK(h.getPercentile(0.5) == 0.0);
+        CHECK(h.getBinCount() == 21);
+    }
+
+    SECTION("Statistics")
+    {
+        // a 60 Hz display: mostly one frame, some two
+        for (int i = 0; i < 8; ++i)
+        {
+            h.add(16.4);
+        }
+        h.add(33.1);
+        h.add(2.5);
+
+        CHECK(h.getCount() == 10);
+        CHECK(h.getMean() == Approx((8 * 16.4 + 33.1 + 2.5) / 10.0));
+        CHECK(h.getMin() == 2.5);
+        CHECK(h.getMax() == 33.1);
+
+        CHECK(h.getBin(16) == 8);
+        CHECK(h.getBin(2) == 1);
+        CHECK(h.getBin(20) == 1); // the overflow bin
+        CHECK(h.getBin(100) == 0);
+
+        CHECK(h.getPercentile(0.1) == 3.0);
+        CHECK(h.getPercentile(0.5) == 17.0);
+        CHECK(h.getPercentile(0.9) == 17.0);
+        CHECK(h.getPercentile(1.0) == 33.1);
+    }
+
+    SECTION("Negative latencies count as none")
+    {
+        h.add(-1.0);
+        CHECK(h.getBin(0) == 1);
+        CHECK(h.getMin() == 0.0);
+    }
+
+    SECTION("Output")
+    {
+        h.add(16.4);
+        h.add(25.0);
+
+        std::ostringstream out;
+        out << h;
+        CHECK(out.str() == "n 2, mean 20.70 ms, min 16.40 ms, median 17.00 ms, "
+                           "95% 25.00 ms, max 25.00 ms\n"
+                           "    16  ms: 1\n"
+                           "    20+ ms: 1\n");
+    }
+
+    SECTION("No bins")
+    {
+        CHECK_THROWS_AS(LatencyHistogram(0), std::runtime_error);
+    }
+}
@@ -0,0 +1,110 @@
+#include "../DwellTrigger.h"
+
+#include "../ScreenPositionStore.h"
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace
+{
+    // 1 kHz gaze at (x, y) from sample first to last
+    void look(ScreenPositionStore &store, std::chrono::steady_clock::time_point t0,
+              unsigned int first, unsigned int last, unsigned int x, unsigned int y)
+    {
+        for (unsigned int n = first; n <= last; ++n)
+        {
+            store.setCurrentPositionRightLeft(std::make_pair(x, y), std::make_pair(x, y),
+                                              n, t0 + std::chrono::milliseconds(n));
+        }
+    }
+}
+
+TEST_CASE("DwellTrigger", "[DwellTrigger]")
+{
+    CHECK_THROWS_AS(DwellTrigger(0.0, 10.0), std::runtime_error);
+    CHECK_THROWS_AS(DwellTrigger(100.0, 0.0), std::runtime_error);
+
+    ScreenPositionStore store;
+    DwellTrigger trigger(100.0, 20.0);
+    store.setListener(&trigger);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    GazeSample fired;
+
+    SECTION("Not armed")
+    {
+        look(store, t0, 0, 500, 500, 500);
+        CHECK(!trigger.poll(fired));
+    }
+
+    SECTION("Fires at the sample the dwell completes on, once")
+    {
+        trigger.arm(std::make_pair(500u, 500u));
+
+        // off target, then on target but not long enough
+        look(store, t0, 0, 200, 600, 500);
+        look(store, t0, 201, 250, 510, 505);
+        CHECK(!trigger.poll(fired));
+
+        // leaving the target starts the dwell again
+        look(store, t0, 251, 260, 600, 600);
+        look(store, t0, 261, 360, 490, 500);
+        CHECK(!trigger.poll(fired));
+
+        look(store, t0, 361, 400, 490, 500);
+        REQUIRE(trigger.poll(fired));
+        CHECK(fired.identifier == 361.0);
+        CHECK(fired.sampleTime == t0 + std::chrono::milliseconds(361));
+
+        // it's disarmed once fired
+        CHECK(!trigger.poll(fired));
+        look(store, t0, 401, 600, 500, 500);
+        CHECK(!trigger.poll(fired));
+    }
+
+    SECTION("Lost tracking restarts the dwell")
+    {
+        trigger.arm(std::make_pair(500u, 500u));
+        look(store, t0, 0, 80, 500, 500);
+        store.setCurrentPositionRightLeft(
+            std::make_pair(common::invalidCoord, common::invalidCoord),
+            std::make_pair(common::invalidCoord, common::invalidCoord),
+            81, t0 + std::chrono::milliseconds(81));
+        look(store, t0, 82, 150, 500, 500);
+        CHECK(!trigger.poll(fired));
+        look(store, t0, 151, 182, 500, 500);
+        REQUIRE(trigger.poll(fired));
+        CHECK(fired.identifier == 182.0);
+    }
+
+    SECTION("Firings from before re-arming are dropped")
+    {
+        trigger.arm(std::make_pair(500u, 500u));
+        look(store, t0, 0, 150, 500, 500);
+
+        trigger.arm(std::make_pair(100u, 100u));
+        CHECK(!trigger.poll(fired));
+
+        trigger.disarm();
+        look(store, t0, 151, 400, 100, 100);
+        CHECK(!trigger.poll(fired));
+    }
+
+    SECTION("Re-arming after a firing leaves the new target armed")
+    {
+        trigger.arm(std::make_pair(500u, 500u));
+        look(store, t0, 0, 150, 500, 500);
+
+        trigger.disarm();
+        trigger.arm(std::make_pair(100u, 100u));
+        CHECK(!trigger.poll(fired));
+
+        look(store, t0, 151, 400, 100, 100);
+        REQUIRE(trigger.poll(fired));
+        CHECK(fired.identifier == 251.0);
+    }
+
+    store.setListener(nullptr);
+}
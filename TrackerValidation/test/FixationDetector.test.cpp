@@ -0,0 +1,148 @@
+#include "../FixationDetector.h"
+
+#include "../common.h"
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace
+{
+    const auto t0 = std::chrono::steady_clock::now();
+
+    // 1 kHz samples, n ms from t0
+    GazeSample makeSample(unsigned int n, unsigned int x, unsigned int y,
+                          bool valid = true)
+    {
+        GazeSample s;
+        s.right = (valid ? std::make_pair(x, y)
+                         : std::make_pair(common::invalidCoord, common::invalidCoord));
+        s.left = s.right;
+        s.rightValid = valid;
+        s.leftValid = valid;
+        s.identifier = n;
+        s.sampleTime = t0 + std::chrono::milliseconds(n);
+        s.arrival = s.sampleTime;
+        s.sequence = n;
+        return s;
+    }
+
+    // fixate at (x, y) from sample first to last, with +/-1 pixel of jitter
+    void fixate(FixationDetector &detector, unsigned int first, unsigned int last,
+                unsigned int x, unsigned int y)
+    {
+        for (unsigned int n = first; n <= last; ++n)
+        {
+            detector.addSample(makeSample(n, x + (n % 3) - 1, y + (n % 2)));
+        }
+    }
+
+    // 20 ms saccade between two points
+    void saccade(FixationDetector &detector, unsigned int first,
+                 unsigned int x0, unsigned int y0,
+                 unsigned int x1, unsigned int y1)
+    {
+        for (unsigned int i = 0; i < 20; ++i)
+        {
+            detector.addSample(makeSample(first + i,
+                                          x0 + (x1 - x0) * i / 20,
+                                          y0 + (y1 - y0) * i / 20));
+        }
+    }
+}
+
+TEST_CASE("FixationDetector", "[FixationDetector]")
+{
+    SECTION("Settings")
+    {
+        CHECK(FixationDetector(FixationDetector::Method::Velocity).getThreshold()
+              == FixationDetector::defaultVelocityThreshold);
+        CHECK(FixationDetector(FixationDetector::Method::Dispersion).getThreshold()
+              == FixationDetector::defaultDispersionThreshold);
+        CHECK(FixationDetector(FixationDetector::Method::Dispersion, 20.0).getThreshold()
+              == 20.0);
+
+        CHECK(FixationDetector::methodFromName("ivt") == FixationDetector::Method::Velocity);
+        CHECK(FixationDetector::methodFromName("idt") == FixationDetector::Method::Dispersion);
+        CHECK_THROWS_AS(FixationDetector::methodFromName("xyz"), std::runtime_error);
+        CHECK_THROWS_AS(FixationDetector(FixationDetector::Method::Velocity, -1.0),
+                        std::runtime_error);
+    }
+
+    for (FixationDetector::Method method : { FixationDetector::Method::Velocity,
+                                             FixationDetector::Method::Dispersion })
+    {
+        DYNAMIC_SECTION("Fixation, saccade, fixation, blink "
+                        << (method == FixationDetector::Method::Velocity ? "I-VT" : "I-DT"))
+        {
+            FixationDetector detector(method);
+
+            fixate(detector, 0, 49, 100, 100);
+            CHECK(!detector.inFixation()); // not long enough yet
+
+            fixate(detector, 50, 299, 100, 100);
+            REQUIRE(detector.inFixation());
+            Fixation f = detector.getCurrentFixation();
+            CHECK(f.x == Approx(100.0).margin(1.0));
+            CHECK(f.y == Approx(100.0).margin(1.0));
+            CHECK(f.getDuration() > 250.0);
+            CHECK(detector.getFixationCount() == 0);
+
+            saccade(detector, 300, 100, 100, 600, 400);
+            CHECK(!detector.inFixation());
+            CHECK(detector.getFixationCount() == 1);
+            REQUIRE(detector.getLastFixation(f));
+            CHECK(f.x == Approx(100.0).margin(1.0));
+            CHECK(f.getDuration() > 250.0);
+
+            fixate(detector, 320, 519, 600, 400);
+            REQUIRE(detector.inFixation());
+            f = detector.getCurrentFixation();
+            CHECK(f.x == Approx(600.0).margin(1.0));
+            CHECK(f.y == Approx(400.0).margin(1.0));
+            CHECK(f.getDuration() > 150.0);
+
+            CHECK(detector.addSample(makeSample(520, 0, 0, false)) == GazeEventType::Blink);
+            CHECK(!detector.inFixation());
+            CHECK(detector.getFixationCount() == 2);
+            REQUIRE(detector.getLastFixation(f));
+            CHECK(f.x == Approx(600.0).margin(1.0));
+        }
+    }
+
+    SECTION("Gaps end a fixation")
+    {
+        FixationDetector detector;
+        fixate(detector, 0, 200, 100, 100);
+        REQUIRE(detector.inFixation());
+
+        fixate(detector, 1000, 1010, 100, 100);
+        CHECK(!detector.inFixation());
+        CHECK(detector.getFixationCount() == 1);
+    }
+
+    SECTION("Tracker finds the fixation after onset")
+    {
+        ScreenPositionStore store;
+        FixationTracker tracker(store, FixationDetector());
+        tracker.start();
+
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned int n = 0; n < 200; ++n)
+        {
+            store.setCurrentPositionRightLeft(std::make_pair(300u, 200u),
+                                              std::make_pair(300u, 200u), n,
+                                              start + std::chrono::milliseconds(n));
+        }
+
+        Fixation f;
+        REQUIRE(tracker.getFixation(start, f));
+        CHECK(f.x == 300.0);
+        CHECK(f.y == 200.0);
+        CHECK(f.count == 200);
+
+        CHECK(!tracker.getFixation(start + std::chrono::milliseconds(1), f));
+        tracker.stop();
+    }
+}
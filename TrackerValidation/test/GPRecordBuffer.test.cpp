@@ -0,0 +1,103 @@
+#include "../gazepoint/GPRecordBuffer.h"
+
+#include "catch.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // write data into the buffer as if it had been received
+    void receive(GPRecordBuffer &buf, const std::string &data)
+    {
+        char *dest = buf.write_ptr();
+        REQUIRE(buf.write_space() >= data.size());
+        std::memcpy(dest, data.data(), data.size());
+        buf.commit(data.size());
+    }
+
+    std::vector<std::string> drain(GPRecordBuffer &buf)
+    {
+        std::vector<std::string> records;
+        std::string_view record;
+        while (buf.next_record(record))
+        {
+            records.emplace_back(record);
+        }
+        return records;
+    }
+}
+
+TEST_CASE("GPRecordBuffer", "[GPRecordBuffer]")
+{
+    GPRecordBuffer buf(64);
+
+    SECTION("Empty buffer")
+    {
+        std::string_view record;
+        CHECK(buf.next_record(record) == false);
+        CHECK(buf.pending() == 0);
+        CHECK(buf.write_space() == 64);
+    }
+
+    SECTION("Complete records")
+    {
+        receive(buf, "<A />\r\n<B />\r\n");
+        std::vector<std::string> records = drain(buf);
+        REQUIRE(records.size() == 2);
+        CHECK(records[0] == "<A />");
+        CHECK(records[1] == "<B />");
+        CHECK(buf.pending() == 0);
+    }
+
+    SECTION("Record split across receives")
+    {
+        receive(buf, "<REC CN");
+        CHECK(drain(buf).empty());
+
+        receive(buf, "T=\"1\" />\r");
+        CHECK(drain(buf).empty());
+
+        receive(buf, "\n<REC");
+        std::vector<std::string> records = drain(buf);
+        REQUIRE(records.size() == 1);
+        CHECK(records[0] == "<REC CNT=\"1\" />");
+        CHECK(buf.pending() == 4);
+    }
+
+    SECTION("Partial record survives compaction")
+    {
+        // fill most of the buffer, leaving a partial record at the end
+        receive(buf, std::string(40, 'x') + "\r\n" + "<PART");
+        CHECK(drain(buf).size() == 1);
+
+        // not enough room at the end, so the partial record moves to the front
+        receive(buf, std::string(30, 'y') + "\r\n");
+        std::vector<std::string> records = drain(buf);
+        REQUIRE(records.size() == 1);
+        CHECK(records[0] == "<PART" + std::string(30, 'y'));
+    }
+
+    SECTION("Bare newline delimiter")
+    {
+        receive(buf, "one\ntwo\r\n");
+        std::vector<std::string> records = drain(buf);
+        REQUIRE(records.size() == 2);
+        CHECK(records[0] == "one");
+        CHECK(records[1] == "two");
+    }
+
+    SECTION("Overlong record is discarded")
+    {
+        receive(buf, std::string(64, 'z'));
+        CHECK(drain(buf).empty());
+
+        // next write finds the buffer full and throws the data away
+        receive(buf, "ok\r\n");
+        CHECK(buf.overflow_count() == 1);
+        std::vector<std::string> records = drain(buf);
+        REQUIRE(records.size() == 1);
+        CHECK(records[0] == "ok");
+    }
+}
@@ -0,0 +1,277 @@
+#include "../GazeRecording.h"
+
+#include "../common.h"
+
+#include "catch.hpp"
+#include "TempFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdio.h>
+#include <stdexcept>
+
+TEST_CASE("GazeRecording", "[GazeRecording]")
+{
+    TempFile tmp;
+    const std::string &tmpFile = tmp.getPath();
+
+    SECTION("Write and read back")
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        {
+            GazeRecordingWriter writer(tmpFile);
+
+            GazeSample s;
+            s.right = std::make_pair(100, 200);
+            s.left = std::make_pair(common::invalidCoord, common::invalidCoord);
+            s.rightValid = true;
+            s.leftValid = false;
+            s.identifier = 1234.5;
+            s.arrival = start;
+            s.sequence = 99;
+            writer.write(s);
+
+            s.right = std::make_pair(101, 202);
+            s.left = std::make_pair(3, 4);
+            s.leftValid = true;
+            s.identifier = 1235.0;
+            s.arrival = start + std::chrono::microseconds(500);
+            writer.write(s);
+
+            CHECK(writer.getCount() == 2);
+        }
+
+        GazeRecordingReader reader(tmpFile);
+        GazeSample s;
+
+        REQUIRE(reader.next(s));
+        CHECK(s.right == std::pair<unsigned int, unsigned int>(100, 200));
+        CHECK(s.left.first == common::invalidCoord);
+        CHECK(s.rightValid == true);
+        CHECK(s.leftValid == false);
+        CHECK(s.identifier == 1234.5);
+        CHECK(s.arrival.time_since_epoch() == std::chrono::steady_clock::duration::zero());
+        CHECK(s.sequence == 0);
+
+        REQUIRE(reader.next(s));
+        CHECK(s.right == std::pair<unsigned int, unsigned int>(101, 202));
+        CHECK(s.left == std::pair<unsigned int, unsigned int>(3, 4));
+        CHECK(s.leftValid == true);
+        CHECK(s.identifier == 1235.0);
+        CHECK(s.arrival.time_since_epoch() == std::chrono::microseconds(500));
+        CHECK(s.sequence == 1);
+
+        CHECK(!reader.next(s));
+    }
+
+    SECTION("Sample times and targets")
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        {
+            GazeRecordingWriter writer(tmpFile);
+
+            GazeSample s;
+            s.right = std::make_pair(500, 400);
+            s.left = std::make_pair(480, 410);
+            s.rightValid = true;
+            s.leftValid = true;
+            s.identifier = 100.25;
+            s.arrival = start;
+            s.sampleTime = start - std::chrono::microseconds(3500);
+            s.sequence = 0;
+            writer.write(s, GazeTargetState{ 3, true });
+
+            s.right = std::make_pair(498, 405);
+            s.identifier = 100.2625;
+            s.arrival = start + std::chrono::milliseconds(7);
+            s.sampleTime = s.arrival + std::chrono::microseconds(100);
+            writer.write(s, GazeTargetState{ 3, false });
+
+            s.identifier = 100.275;
+            writer.write(s, GazeTargetState{ 0, true });
+        }
+
+        GazeRecordingReader reader(tmpFile);
+        CHECK(reader.getVersion() == 2);
+        GazeSample s;
+        GazeTargetState target;
+
+        REQUIRE(reader.next(s, &target));
+        CHECK(s.sampleTime.time_since_epoch() == std::chrono::microseconds(-3500));
+        CHECK(s.left == std::pair<unsigned int, unsigned int>(480, 410));
+        CHECK(target.index == 3);
+        CHECK(target.visible);
+
+        // the start time is about now
+        const auto age = std::chrono::system_clock::now() - reader.getStartTime();
+        CHECK(age >= std::chrono::seconds(0));
+        CHECK(age < std::chrono::seconds(10));
+
+        REQUIRE(reader.next(s, &target));
+        CHECK(s.right == std::pair<unsigned int, unsigned int>(498, 405));
+        CHECK(s.left == std::pair<unsigned int, unsigned int>(480, 410));
+        CHECK(s.identifier == 100.2625);
+        CHECK(s.arrival.time_since_epoch() == std::chrono::milliseconds(7));
+        CHECK(s.sampleTime.time_since_epoch() == std::chrono::microseconds(7100));
+        CHECK(target.index == 3);
+        CHECK(!target.visible);
+
+        REQUIRE(reader.next(s, &target));
+        CHECK(s.identifier == 100.275);
+        CHECK(target.index == 0);
+        CHECK(target.visible);
+
+        CHECK(!reader.next(s));
+    }
+
+    SECTION("Samples are compact")
+    {
+        const unsigned int n = 1500;
+        {
+            GazeRecordingWriter writer(tmpFile);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            GazeSample s;
+            s.rightValid = true;
+            s.leftValid = false;
+            for (unsigned int i = 0; i < n; ++i)
+            {
+                s.right = std::make_pair(900 + i % 7, 500 - i % 5);
+                s.left = std::make_pair(common::invalidCoord, common::invalidCoord);
+                s.identifier = 1000.0 + i / 150.0;
+                s.arrival = start + std::chrono::microseconds(i * 6667 + i % 300);
+                s.sampleTime = s.arrival - std::chrono::milliseconds(4);
+                writer.write(s, GazeTargetState{ i / 100, true });
+            }
+        }
+
+        std::ifstream in(tmpFile, std::ios::binary | std::ios::ate);
+        CHECK(static_cast<std::size_t>(in.tellg()) < n * 20);
+
+        GazeRecordingReader reader(tmpFile);
+        GazeSample s;
+        GazeTargetState target;
+        unsigned int i = 0;
+        while (reader.next(s, &target))
+        {
+            REQUIRE(s.right == std::pair<unsigned int, unsigned int>(900 + i % 7, 500 - i % 5));
+            REQUIRE(s.left.first == common::invalidCoord);
+            REQUIRE(s.identifier == 1000.0 + i / 150.0);
+            REQUIRE(target.index == i / 100);
+            ++i;
+        }
+        CHECK(i == n);
+    }
+
+    SECTION("Version 1 recordings")
+    {
+        {
+            std::ofstream out(tmpFile, std::ios::binary);
+            out.write("GAZEREC1", 8);
+
+            unsigned char record[33] = {};
+            const double identifier = 42.0;
+            std::uint64_t bits;
+            std::memcpy(&bits, &identifier, sizeof(bits));
+            for (int i = 0; i < 8; ++i)
+            {
+                record[i] = static_cast<unsigned char>(bits >> (8 * i));
+            }
+            record[8] = 0xe8; // 1000 ns
+            record[8 + 1] = 0x03;
+            record[16] = 7;   // right x
+            record[20] = 8;   // right y
+            record[32] = 0x1; // right valid
+            out.write(reinterpret_cast<const char *>(record), sizeof(record));
+        }
+
+        GazeRecordingReader reader(tmpFile);
+        CHECK(reader.getVersion() == 1);
+        GazeSample s;
+        REQUIRE(reader.next(s));
+        CHECK(s.identifier == 42.0);
+        CHECK(s.arrival.time_since_epoch() == std::chrono::microseconds(1));
+        CHECK(s.sampleTime == s.arrival);
+        CHECK(s.right == std::pair<unsigned int, unsigned int>(7, 8));
+        CHECK(s.rightValid);
+        CHECK(!s.leftValid);
+        CHECK(!reader.next(s));
+    }
+
+    SECTION("Record a store with targets")
+    {
+        ScreenPositionStore store;
+        {
+            GazeRecorder recorder(store, tmpFile);
+            recorder.start();
+            for (unsigned int i = 0; i < 100; ++i)
+            {
+                if (i % 10 == 0)
+                {
+                    recorder.setTarget(i / 10, i % 20 == 0);
+                }
+                store.setCurrentPositionSingle(std::make_pair(i, i), static_cast<double>(i));
+            }
+            recorder.stop();
+            REQUIRE(recorder.getLostCount() == 0);
+        }
+
+        GazeRecordingReader reader(tmpFile);
+        GazeSample s;
+        GazeTargetState target;
+        unsigned int i = 0;
+        while (reader.next(s, &target))
+        {
+            REQUIRE(s.identifier == static_cast<double>(i));
+            REQUIRE(target.index == i / 10);
+            REQUIRE(target.visible == (i % 20 < 10));
+            ++i;
+        }
+        CHECK(i == 100);
+    }
+
+    SECTION("Record a store")
+    {
+        ScreenPositionStore store;
+        store.setCurrentPositionSingle(std::make_pair(1, 1), 1.0); // before recording
+
+        {
+            GazeRecorder recorder(store, tmpFile);
+            recorder.start();
+            for (unsigned int i = 0; i < 10000; ++i)
+            {
+                store.setCurrentPositionRightLeft(std::make_pair(i, i + 1),
+                                                  std::make_pair(i + 2, i + 3),
+                                                  static_cast<double>(i));
+            }
+            recorder.stop();
+
+            CHECK(recorder.getRecordedCount() + recorder.getLostCount() == 10000);
+        }
+
+        // everything which was recorded is in order and intact
+        GazeRecordingReader reader(tmpFile);
+        GazeSample s;
+        double lastId = -1.0;
+        while (reader.next(s))
+        {
+            REQUIRE(s.identifier > lastId);
+            unsigned int i = static_cast<unsigned int>(s.identifier);
+            REQUIRE(s.right == std::pair<unsigned int, unsigned int>(i, i + 1));
+            REQUIRE(s.left == std::pair<unsigned int, unsigned int>(i + 2, i + 3));
+            lastId = s.identifier;
+        }
+        CHECK(lastId == 9999.0);
+    }
+
+    SECTION("Not a recording")
+    {
+        FILE *f = fopen(tmpFile.c_str(), "w");
+        REQUIRE(f != nullptr);
+        fputs("hello", f);
+        fclose(f);
+
+        CHECK_THROWS_AS(GazeRecordingReader(tmpFile), std::runtime_error);
+    }
+
+}
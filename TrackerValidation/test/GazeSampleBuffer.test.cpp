@@ -0,0 +1,138 @@
+#include "../GazeSampleBuffer.h"
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    GazeSample makeSample(unsigned int x, double id,
+                          std::chrono::steady_clock::time_point t)
+    {
+        GazeSample s;
+        s.right = std::make_pair(x, x + 1);
+        s.left = std::make_pair(x + 2, x + 3);
+        s.rightValid = true;
+        s.leftValid = (x % 2 == 0);
+        s.identifier = id;
+        s.arrival = t;
+        s.sampleTime = t - std::chrono::microseconds(x);
+        s.sequence = 0;
+        return s;
+    }
+}
+
+TEST_CASE("GazeSampleBuffer", "[GazeSampleBuffer]")
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto ms = std::chrono::milliseconds(1);
+
+    SECTION("Empty buffer")
+    {
+        GazeSampleBuffer buf(8);
+        GazeSample s;
+        CHECK(buf.latest(s) == false);
+        CHECK(buf.pushed() == 0);
+
+        std::vector<GazeSample> out;
+        CHECK(buf.snapshot(t0, t0 + ms, out) == 0);
+    }
+
+    SECTION("Capacity rounded up to a power of two")
+    {
+        CHECK(GazeSampleBuffer(5).capacity() == 8);
+        CHECK(GazeSampleBuffer(8).capacity() == 8);
+        CHECK(GazeSampleBuffer(0).capacity() == 2);
+    }
+
+    SECTION("Latest sample round trip")
+    {
+        GazeSampleBuffer buf(8);
+        buf.push(makeSample(100, 12.5, t0));
+        buf.push(makeSample(201, -3.0, t0 + ms));
+
+        GazeSample s;
+        REQUIRE(buf.latest(s));
+        CHECK(s.right == std::pair<unsigned int, unsigned int>(201, 202));
+        CHECK(s.left == std::pair<unsigned int, unsigned int>(203, 204));
+        CHECK(s.rightValid == true);
+        CHECK(s.leftValid == false);
+        CHECK(s.identifier == -3.0);
+        CHECK(s.arrival == t0 + ms);
+        CHECK(s.sampleTime == t0 + ms - std::chrono::microseconds(201));
+        CHECK(s.sequence == 1);
+        CHECK(buf.pushed() == 2);
+    }
+
+    SECTION("Snapshot by time range")
+    {
+        GazeSampleBuffer buf(16);
+        for (unsigned int i = 0; i < 10; ++i)
+        {
+            buf.push(makeSample(i, i, t0 + i * ms));
+        }
+
+        std::vector<GazeSample> out;
+        REQUIRE(buf.snapshot(t0 + 3 * ms, t0 + 6 * ms, out) == 4);
+        CHECK(out.front().identifier == 3.0);
+        CHECK(out.back().identifier == 6.0);
+        CHECK(out[1].sequence == 4);
+    }
+
+    SECTION("Old samples are overwritten")
+    {
+        GazeSampleBuffer buf(4);
+        for (unsigned int i = 0; i < 10; ++i)
+        {
+            buf.push(makeSample(i, i, t0 + i * ms));
+        }
+
+        std::vector<GazeSample> out;
+        REQUIRE(buf.snapshot(t0, t0 + 10 * ms, out) == 4);
+        CHECK(out.front().identifier == 6.0);
+        CHECK(out.back().identifier == 9.0);
+    }
+
+    SECTION("Readers never see a torn sample")
+    {
+        GazeSampleBuffer buf(16);
+        std::atomic<bool> done(false);
+
+        // every sample has all fields derived from x, so any mixing of two
+        // samples is detectable
+        std::thread producer([&]() {
+            for (unsigned int i = 0; i < 200000; ++i)
+            {
+                buf.push(makeSample(i, i, t0 + i * ms));
+            }
+            done = true;
+        });
+
+        bool consistent = true;
+        GazeSample s;
+        std::vector<GazeSample> out;
+        while (!done)
+        {
+            if (buf.latest(s))
+            {
+                consistent &= (s.right.second == s.right.first + 1)
+                              && (s.left.first == s.right.first + 2)
+                              && (s.identifier == s.right.first)
+                              && (s.sequence == s.right.first);
+            }
+
+            buf.snapshot(t0, t0 + std::chrono::hours(1), out);
+            for (size_t i = 1; i < out.size(); ++i)
+            {
+                consistent &= (out[i].sequence == out[i - 1].sequence + 1);
+            }
+        }
+        producer.join();
+
+        CHECK(consistent);
+        CHECK(buf.pushed() == 200000);
+    }
+}
@@ -0,0 +1,93 @@
+#include "../GazeWindowStats.h"
+
+#include "../common.h"
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <vector>
+
+namespace
+{
+    GazeSample makeSample(unsigned int rx, unsigned int ry, bool leftValid,
+                          std::chrono::steady_clock::time_point t)
+    {
+        GazeSample s;
+        s.right = std::make_pair(rx, ry);
+        s.left = (leftValid ? std::make_pair(rx + 10, ry + 10)
+                            : std::make_pair(common::invalidCoord, common::invalidCoord));
+        s.rightValid = true;
+        s.leftValid = leftValid;
+        s.identifier = 0.0;
+        s.arrival = t;
+        s.sampleTime = t;
+        s.sequence = 0;
+        return s;
+    }
+}
+
+TEST_CASE("GazeWindowStats", "[GazeWindowStats]")
+{
+    GazeWindowAggregator aggregator;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    SECTION("Mean, median and SD")
+    {
+        std::vector<GazeSample> window;
+        window.push_back(makeSample(100, 200, true, t0));
+        window.push_back(makeSample(102, 200, false, t0));
+        window.push_back(makeSample(104, 200, true, t0));
+        window.push_back(makeSample(110, 204, true, t0));
+
+        GazeWindowStats stats = aggregator.aggregate(window);
+
+        CHECK(stats.right.count == 4);
+        CHECK(stats.right.meanX == 104.0);
+        CHECK(stats.right.meanY == 201.0);
+        CHECK(stats.right.medianX == 103.0);
+        CHECK(stats.right.medianY == 200.0);
+        CHECK(stats.right.sdX == Approx(4.320494));
+        CHECK(stats.right.sdY == 2.0);
+        CHECK(stats.right.rmsS2S == Approx(4.472136));
+
+        // invalid samples are skipped
+        CHECK(stats.left.count == 3);
+        CHECK(stats.left.medianX == 114.0);
+        CHECK(stats.left.meanY == Approx(211.333333));
+    }
+
+    SECTION("No valid data")
+    {
+        std::vector<GazeSample> window;
+        CHECK(aggregator.aggregate(window).right.count == 0);
+
+        window.push_back(makeSample(1, 2, false, t0));
+        GazeWindowStats stats = aggregator.aggregate(window);
+        CHECK(stats.right.count == 1);
+        CHECK(stats.right.sdX == 0.0);
+        CHECK(stats.right.rmsS2S == 0.0);
+        CHECK(stats.left.count == 0);
+    }
+
+    SECTION("From a store, by time")
+    {
+        ScreenPositionStore store;
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < 100; ++i)
+        {
+            store.setCurrentPositionRightLeft(std::make_pair(i, i), std::make_pair(i, i));
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        // everything we pushed, but not the sample from the constructor
+        GazeWindowStats stats = aggregator.aggregate(store, start, end);
+        CHECK(stats.right.count == 100);
+        CHECK(stats.left.meanX == 49.5);
+
+        // samples taken before the window are excluded, even if they arrived in it
+        store.setCurrentPositionRightLeft(std::make_pair(5, 5), std::make_pair(5, 5), 0.0,
+                                          start - std::chrono::seconds(1));
+        stats = aggregator.aggregate(store, start, std::chrono::steady_clock::now());
+        CHECK(stats.right.count == 100);
+    }
+}
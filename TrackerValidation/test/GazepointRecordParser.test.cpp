@@ -0,0 +1,77 @@
+#include "../GazepointRecordParser.h"
+
+#include "catch.hpp"
+
+TEST_CASE("GazepointRecordParser", "[GazepointRecordParser]")
+{
+    GazepointRecordParser parser;
+    GazepointRecord rec;
+
+    SECTION("Standard record")
+    {
+        REQUIRE(parser.parse("<REC CNT=\"151747\" LPOGX=\"0.87396\" LPOGY=\"0.02765\" LPOGV=\"1\" RPOGX=\"0.89497\" RPOGY=\"0.77830\" RPOGV=\"0\" />", rec)
+                == GazepointRecordParser::RESULT_OK);
+
+        CHECK(rec.cnt == 151747.0);
+        CHECK(rec.lpogx == 0.87396);
+        CHECK(rec.lpogy == 0.02765);
+        CHECK(rec.lpogv == true);
+        CHECK(rec.rpogx == 0.89497);
+        CHECK(rec.rpogy == 0.77830);
+        CHECK(rec.rpogv == false);
+        CHECK(rec.fields == (GazepointRecordParser::FIELD_CNT
+                             | GazepointRecordParser::FIELD_LPOGX
+                             | GazepointRecordParser::FIELD_LPOGY
+                             | GazepointRecordParser::FIELD_LPOGV
+                             | GazepointRecordParser::FIELD_RPOGX
+                             | GazepointRecordParser::FIELD_RPOGY
+                             | GazepointRecordParser::FIELD_RPOGV));
+        CHECK(parser.getParsedCount() == 1);
+        CHECK(parser.getErrorCount() == 0);
+    }
+
+    SECTION("Reordered and extra attributes")
+    {
+        REQUIRE(parser.parse("<REC TIME=\"12.5\" FPOGX=\"0.1\" BPOGY=\"-0.25\" CNT=\"7\" BPOGX=\"1.5\" BPOGV=\"1\"/>", rec)
+                == GazepointRecordParser::RESULT_OK);
+
+        CHECK(rec.time == 12.5);
+        CHECK(rec.cnt == 7.0);
+        CHECK(rec.bpogx == 1.5);
+        CHECK(rec.bpogy == -0.25);
+        CHECK(rec.bpogv == true);
+        CHECK((rec.fields & GazepointRecordParser::FIELD_LPOGX) == 0);
+        CHECK(rec.lpogx == 0.0);
+    }
+
+    SECTION("Other messages are ignored")
+    {
+        CHECK(parser.parse("<ACK ID=\"ENABLE_SEND_DATA\" STATE=\"1\" />", rec)
+              == GazepointRecordParser::RESULT_NOT_RECORD);
+        CHECK(parser.parse("<RECORD CNT=\"1\" />", rec)
+              == GazepointRecordParser::RESULT_NOT_RECORD);
+        CHECK(parser.parse("", rec) == GazepointRecordParser::RESULT_NOT_RECORD);
+        CHECK(parser.getIgnoredCount() == 3);
+        CHECK(parser.getErrorCount() == 0);
+    }
+
+    SECTION("Malformed records are counted")
+    {
+        CHECK(parser.parse("<REC CNT=\"12\"", rec) == GazepointRecordParser::RESULT_ERROR);
+        CHECK(parser.parse("<REC CNT=\"12 />", rec) == GazepointRecordParser::RESULT_ERROR);
+        CHECK(parser.parse("<REC CNT=12 />", rec) == GazepointRecordParser::RESULT_ERROR);
+        CHECK(parser.parse("<REC LPOGX=\"abc\" />", rec) == GazepointRecordParser::RESULT_ERROR);
+        CHECK(parser.parse("<REC LPOGX=\"0.5x\" />", rec) == GazepointRecordParser::RESULT_ERROR);
+        CHECK(parser.getErrorCount() == 5);
+        CHECK(parser.getParsedCount() == 0);
+    }
+
+    SECTION("Required fields")
+    {
+        CHECK(parser.parse("<REC CNT=\"1\" />", rec, GazepointRecordParser::FIELD_CNT)
+              == GazepointRecordParser::RESULT_OK);
+        CHECK(parser.parse("<REC CNT=\"1\" />", rec, GazepointRecordParser::FIELD_LPOGX)
+              == GazepointRecordParser::RESULT_ERROR);
+        CHECK(parser.getErrorCount() == 1);
+    }
+}
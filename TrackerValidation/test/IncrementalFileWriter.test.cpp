@@ -0,0 +1,101 @@
+#include "../IncrementalFileWriter.h"
+
+#include "catch.hpp"
+#include "TempFile.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream contents;
+        contents << in.rdbuf();
+        return contents.str();
+    }
+
+    void writeFile(const std::string &path, const std::string &contents)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << contents;
+    }
+}
+
+TEST_CASE("IncrementalFileWriter", "[IncrementalFileWriter]")
+{
+    TempFile tmp;
+    const std::string &path = tmp.getPath();
+
+    SECTION("Rows are written as we go")
+    {
+        for (int sync : { IncrementalFileWriter::syncNever,
+                          IncrementalFileWriter::syncEveryBatch, 1000 })
+        {
+            std::remove(path.c_str());
+            IncrementalFileWriter writer(path, sync);
+            CHECK(writer.getRecoveredBytes() == 0);
+
+            CHECK(writer.append("a,b\n"));
+            CHECK(writer.append("1,2\n"));
+            REQUIRE(writer.flush());
+            CHECK(readFile(path) == "a,b\n1,2\n");
+
+            CHECK(writer.append("3,4\n"));
+            CHECK(writer.flush());
+            CHECK(readFile(path) == "a,b\n1,2\n3,4\n");
+            CHECK(!writer.hasFailed());
+        }
+    }
+
+    SECTION("Everything is written on destruction, and appended to")
+    {
+        writeFile(path, "old\n");
+        {
+            IncrementalFileWriter writer(path);
+            for (int i = 0; i < 1000; ++i)
+            {
+                writer.append(std::to_string(i) + "\n");
+            }
+        }
+
+        const std::string contents = readFile(path);
+        CHECK(contents.substr(0, 6) == "old\n0\n");
+        CHECK(contents.substr(contents.size() - 4) == "999\n");
+    }
+
+    SECTION("End an unterminated last line, keeping it")
+    {
+        writeFile(path, "a,b\n1,2\n3,");
+        CHECK(IncrementalFileWriter::recover(path) == 2);
+        CHECK(readFile(path) == "a,b\n1,2\n3,\n");
+        CHECK(IncrementalFileWriter::recover(path) == 0);
+
+        // no newlines at all
+        writeFile(path, std::string(10000, 'x'));
+        CHECK(IncrementalFileWriter::recover(path) == 10000);
+        CHECK(readFile(path) == std::string(10000, 'x') + "\n");
+
+        // and when opening
+        writeFile(path, "a,b\n1,");
+        {
+            IncrementalFileWriter writer(path);
+            CHECK(writer.getRecoveredBytes() == 2);
+            writer.append("3,4\n");
+        }
+        CHECK(readFile(path) == "a,b\n1,\n3,4\n");
+    }
+
+    SECTION("Missing files")
+    {
+        std::remove(path.c_str());
+        CHECK(IncrementalFileWriter::recover(path) == 0);
+        CHECK_THROWS_AS(IncrementalFileWriter(""), std::runtime_error);
+    }
+
+    std::remove(path.c_str());
+}
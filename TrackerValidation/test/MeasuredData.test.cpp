@@ -1,8 +1,13 @@
 #include "../MeasuredData.h"
+#include "../MeasuredDataStream.h"
 
 #include "catch.hpp"
+#include "TempFile.h"
 
-#include <stdio.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
 
 TEST_CASE("MeasuredData factory", "[MeasuredData]")
 {
@@ -30,14 +35,9 @@ TEST_CASE("MeasuredData factory", "[MeasuredData]")
 
     SECTION("Create MeasuredDataFile")
     {
-        char tmpFile[L_tmpnam];
-        #ifndef _WIN32
-        REQUIRE(tmpnam(tmpFile) == tmpFile); // returns pointer to tmpFile on success
-        #else
-        REQUIRE(tmpnam_s(tmpFile, sizeof(tmpFile)) == 0);
-        #endif
+        TempFile tmp;
 
-        MeasuredData* data = MeasuredData::create("file", "label", "tracker", "subject", tmpFile);
+        MeasuredData* data = MeasuredData::create("file", "label", "tracker", "subject", tmp.getPath());
 
         CHECK(data->getLabel() == "label");
         CHECK(data->getTrackerName() == "tracker");
@@ -46,6 +46,68 @@ TEST_CASE("MeasuredData factory", "[MeasuredData]")
         delete data;
     }
 
+    SECTION("MeasuredDataFile writes rows as they are made")
+    {
+        TempFile tmp;
+
+        MeasuredData *data = MeasuredData::create("file", "label", "tracker", "subject", tmp.getPath());
+
+        GazeWindowStats window = {};
+        CHECK(data->writeData(std::chrono::system_clock::now(), 1, 2, 3, 4, 5,
+                              6, 7, 8, 9, 1.5, window, nullptr, nullptr));
+        data->writeBuffer();
+
+        // the header and one row, without deleting the data store
+        std::ifstream in(tmp.getPath());
+        std::string line;
+        unsigned int lines = 0;
+        while (std::getline(in, line))
+        {
+            ++lines;
+        }
+        CHECK(lines == 2);
+
+        delete data;
+    }
+
+    SECTION("MeasuredDataStream writes the target onset")
+    {
+        std::ostringstream out;
+        {
+            MeasuredDataStream data("label", "tracker", "subject", out);
+
+            GazeWindowStats window = {};
+            TargetOnset onset = { std::chrono::system_clock::time_point(
+                                      std::chrono::milliseconds(1500)), 245.25 };
+            CHECK(data.writeData(std::chrono::system_clock::now(), 1, 2, 3, 4, 5,
+                                 6, 7, 8, 9, 1.5, window, nullptr, &onset));
+            CHECK(data.writeData(std::chrono::system_clock::now(), 1, 2, 3, 4, 5,
+                                 6, 7, 8, 9, 1.5, window, nullptr, nullptr));
+            data.writeBuffer();
+        }
+
+        std::istringstream in(out.str());
+        std::string line, header, withOnset, withoutOnset;
+        while (std::getline(in, line))
+        {
+            if (line.compare(0, 8, "\"Label\",") == 0)
+            {
+                header = line;
+                std::getline(in, withOnset);
+                std::getline(in, withoutOnset);
+            }
+        }
+
+        const std::string columns = ",\"Onset-Timestamp-ns\",\"Reaction-Time-ms\"";
+        REQUIRE(header.size() > columns.size());
+        CHECK(header.substr(header.size() - columns.size()) == columns);
+
+        const std::string values = ",1500000000,245.250";
+        REQUIRE(withOnset.size() > values.size());
+        CHECK(withOnset.substr(withOnset.size() - values.size()) == values);
+        CHECK(withoutOnset.substr(withoutOnset.size() - 2) == ",,");
+    }
+
     SECTION("Create MeasuredDataFile with no path")
     {
         REQUIRE_THROWS_AS(MeasuredData::create("file", "l", "t", "s", ""),
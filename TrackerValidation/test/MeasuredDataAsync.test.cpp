@@ -0,0 +1,129 @@
+#include "../MeasuredDataAsync.h"
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // records the target numbers it's given, optionally slowly
+    class SlowData : public MeasuredData
+    {
+      public:
+        std::mutex gate; // held by the test to stall the writer
+        std::vector<unsigned int> targets;
+        std::atomic<unsigned int> buffered;
+        bool haveFixation;
+        double reactionTime;
+
+        SlowData() : MeasuredData("label", "tracker", "subject"), buffered(0),
+                     haveFixation(false), reactionTime(0.0) {}
+
+        bool writeData(std::chrono::time_point<std::chrono::system_clock>,
+                       unsigned int targetNumber,
+                       unsigned int, unsigned int, unsigned int, unsigned int,
+                       unsigned int, unsigned int, unsigned int, unsigned int,
+                       double, const GazeWindowStats &, const Fixation *fixation,
+                       const TargetOnset *onset)
+        {
+            std::lock_guard<std::mutex> lock(gate);
+            targets.push_back(targetNumber);
+            haveFixation = (fixation != nullptr);
+            reactionTime = (onset != nullptr ? onset->reactionTime : -1.0);
+            return targetNumber != 99;
+        }
+
+        void writeBuffer()
+        {
+            ++buffered;
+        }
+    };
+
+    bool write(MeasuredData &data, unsigned int target, const Fixation *fixation = nullptr,
+               const TargetOnset *onset = nullptr)
+    {
+        GazeWindowStats window = {};
+        return data.writeData(std::chrono::system_clock::now(), target,
+                              0, 0, 0, 0, 0, 0, 0, 0, 0.0, window, fixation, onset);
+    }
+}
+
+TEST_CASE("MeasuredDataAsync", "[MeasuredData]")
+{
+    SlowData *store = new SlowData();
+    MeasuredDataAsync data(store, 4);
+
+    CHECK(data.getLabel() == "label");
+    CHECK(data.getSubject() == "subject");
+
+    SECTION("Measurements are written in order")
+    {
+        Fixation f = {};
+        TargetOnset onset = { std::chrono::system_clock::now(), 312.5 };
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            CHECK(write(data, i));
+        }
+        CHECK(write(data, 99, &f, &onset));
+        data.writeBuffer();
+
+        CHECK(store->targets == std::vector<unsigned int>({ 0, 1, 2, 99 }));
+        CHECK(store->haveFixation);
+        CHECK(store->reactionTime == 312.5);
+        CHECK(store->buffered == 1);
+
+        MeasuredDataAsync::Stats stats = data.getStats();
+        CHECK(stats.queued == 4);
+        CHECK(stats.written == 3);
+        CHECK(stats.failed == 1);
+        CHECK(stats.rejected == 0);
+        CHECK(stats.depth == 0);
+        CHECK(stats.maxLatency >= stats.meanLatency);
+    }
+
+    SECTION("Nothing more is accepted once a write has failed")
+    {
+        CHECK(write(data, 99));
+        data.writeBuffer();
+
+        CHECK(!write(data, 1));
+        data.writeBuffer();
+        CHECK(store->targets == std::vector<unsigned int>({ 99 }));
+        CHECK(data.getStats().failed == 1);
+        CHECK(data.getStats().rejected == 1);
+    }
+
+    SECTION("A stalled writer doesn't block, but the buffer fills")
+    {
+        {
+            std::lock_guard<std::mutex> lock(store->gate);
+
+            // the writer takes the first one and gets stuck on it
+            CHECK(write(data, 0));
+            while (data.getStats().depth != 1 || data.getStats().maxDepth != 1)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            const auto start = std::chrono::steady_clock::now();
+            for (unsigned int i = 1; i <= 4; ++i)
+            {
+                CHECK(write(data, i));
+            }
+            CHECK(!write(data, 5));
+            CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(10));
+
+            CHECK(data.getStats().rejected == 1);
+            CHECK(data.getStats().depth == 5);
+        }
+
+        data.writeBuffer();
+        CHECK(store->targets.size() == 5);
+        CHECK(data.getStats().maxDepth == 5);
+    }
+}
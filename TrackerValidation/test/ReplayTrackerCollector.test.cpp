@@ -0,0 +1,84 @@
+#include "../ReplayTrackerCollector.h"
+
+#include "../GazeRecording.h"
+#include "../ScreenPositionStore.h"
+#include "../TrackerConfig.h"
+
+#include "catch.hpp"
+#include "TempFile.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+TEST_CASE("ReplayTrackerCollector", "[ReplayTrackerCollector]")
+{
+    TempFile tmp;
+    const unsigned int n = 20;
+    {
+        // 10 ms apart, each taken 4 ms before it arrived
+        GazeRecordingWriter writer(tmp.getPath());
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        GazeSample s;
+        s.rightValid = true;
+        s.leftValid = true;
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            s.right = std::make_pair(100 + i, 200);
+            s.left = std::make_pair(110 + i, 200);
+            s.identifier = static_cast<double>(i);
+            s.arrival = start + std::chrono::milliseconds(10 * i);
+            s.sampleTime = s.arrival - std::chrono::milliseconds(4);
+            writer.write(s);
+        }
+    }
+
+    TrackerConfig config("", 0);
+    config.replayFile = tmp.getPath();
+
+    // the replay tracker says when it has finished
+    std::ostringstream sink;
+    std::streambuf *original = std::cout.rdbuf(sink.rdbuf());
+
+    ScreenPositionStore store;
+    const std::uint64_t base = store.getSampleBuffer().pushed();
+    const std::chrono::steady_clock::time_point before = std::chrono::steady_clock::now();
+    double speed = 0.0;
+
+    SECTION("As fast as possible keeps the recorded spacing")
+    {
+        speed = 0.0;
+    }
+
+    SECTION("Faster than recorded")
+    {
+        speed = 4.0;
+    }
+
+    config.replaySpeed = speed;
+    {
+        ReplayTrackerCollector replay(store, config);
+        replay.run();
+        while (store.getSampleBuffer().pushed() < base + n)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        replay.stop();
+    }
+    std::cout.rdbuf(original);
+
+    const double scale = (speed > 0.0 ? 1.0 / speed : 1.0);
+    GazeSample first, s;
+    REQUIRE(store.getSampleBuffer().get(base, first));
+    CHECK(first.sampleTime >= before - std::chrono::milliseconds(5));
+    for (unsigned int i = 1; i < n; ++i)
+    {
+        REQUIRE(store.getSampleBuffer().get(base + i, s));
+        CHECK(s.identifier == static_cast<double>(i));
+        const double ms = std::chrono::duration<double, std::milli>(
+            s.sampleTime - first.sampleTime).count();
+        CHECK(ms == Approx(10.0 * i * scale).margin(0.001));
+    }
+}
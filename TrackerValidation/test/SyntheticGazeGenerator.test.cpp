@@ -0,0 +1,142 @@
+#include "../SyntheticGazeGenerator.h"
+
+#include "../common.h"
+
+#include "catch.hpp"
+
+#include <cmath>
+
+namespace
+{
+    // a model with no noise or data loss
+    SyntheticGazeModel perfectModel()
+    {
+        SyntheticGazeModel model;
+        SyntheticEyeModel eye = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        model.right = eye;
+        model.left = eye;
+        model.blinkRate = 0.0;
+        return model;
+    }
+}
+
+TEST_CASE("SyntheticGazeGenerator", "[SyntheticGazeGenerator]")
+{
+    const std::pair<double, double> truth(500.0, 400.0);
+    std::pair<unsigned int, unsigned int> right, left;
+
+    SECTION("Sample times")
+    {
+        SyntheticGazeGenerator gen(perfectModel(), 2000);
+
+        CHECK(gen.next(truth, right, left) == 0.0);
+        CHECK(gen.next(truth, right, left) == 0.5);
+        CHECK(gen.next(truth, right, left) == 1.0);
+        CHECK(gen.getCount() == 3);
+    }
+
+    SECTION("Offset and drift")
+    {
+        SyntheticGazeModel model = perfectModel();
+        model.right.offsetX = 10.0;
+        model.left.offsetY = -20.0;
+        model.left.driftX = 100.0; // px per second
+
+        SyntheticGazeGenerator gen(model, 100);
+        gen.next(truth, right, left);
+        CHECK(right == std::pair<unsigned int, unsigned int>(510, 400));
+        CHECK(left == std::pair<unsigned int, unsigned int>(500, 380));
+
+        // one second later
+        for (int i = 0; i < 100; ++i)
+        {
+            gen.next(truth, right, left);
+        }
+        CHECK(right == std::pair<unsigned int, unsigned int>(510, 400));
+        CHECK(left == std::pair<unsigned int, unsigned int>(600, 380));
+    }
+
+    SECTION("Noise statistics")
+    {
+        SyntheticGazeModel model = perfectModel();
+        model.right.whiteNoise = 3.0;
+        model.left.pinkNoise = 3.0;
+
+        SyntheticGazeGenerator gen(model, 1000);
+        const int n = 20000;
+        double sum[2] = { 0.0, 0.0 }, sumSq[2] = { 0.0, 0.0 };
+        for (int i = 0; i < n; ++i)
+        {
+            gen.next(truth, right, left);
+            double d[2] = { right.first - truth.first, left.first - truth.first };
+            for (int eye = 0; eye < 2; ++eye)
+            {
+                sum[eye] += d[eye];
+                sumSq[eye] += d[eye] * d[eye];
+            }
+        }
+
+        // white noise is unbiased with the requested standard deviation
+        CHECK(std::fabs(sum[0] / n) < 0.2);
+        CHECK(std::sqrt(sumSq[0] / n) == Approx(3.0).epsilon(0.05));
+
+        // pink noise wanders, so only check it's the right order
+        CHECK(std::sqrt(sumSq[1] / n) > 1.0);
+        CHECK(std::sqrt(sumSq[1] / n) < 6.0);
+    }
+
+    SECTION("Blinks and dropouts")
+    {
+        SyntheticGazeModel model = perfectModel();
+        model.right.dropoutRate = 0.1;
+        model.blinkRate = 60.0; // one per second
+        model.blinkDuration = 100.0;
+
+        SyntheticGazeGenerator gen(model, 1000);
+        const int n = 60000;
+        int rightLost = 0, bothLost = 0, leftLost = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            gen.next(truth, right, left);
+            bool r = (right.first == common::invalidCoord);
+            bool l = (left.first == common::invalidCoord);
+            rightLost += r;
+            leftLost += l;
+            bothLost += (r && l);
+        }
+
+        // left eye is only lost to blinks: ~60 blinks of 100 ms in a minute
+        CHECK(leftLost == bothLost);
+        CHECK(leftLost > n / 20);
+        CHECK(leftLost < n / 5);
+
+        // right eye also drops ~10% of the rest
+        CHECK(rightLost - leftLost == Approx(0.1 * (n - leftLost)).epsilon(0.1));
+    }
+
+    SECTION("Same seed, same stream")
+    {
+        SyntheticGazeGenerator a(SyntheticGazeModel(), 500);
+        SyntheticGazeGenerator b(SyntheticGazeModel(), 500);
+        std::pair<unsigned int, unsigned int> right2, left2;
+        for (int i = 0; i < 1000; ++i)
+        {
+            a.next(truth, right, left);
+            b.next(truth, right2, left2);
+            REQUIRE(right == right2);
+            REQUIRE(left == left2);
+        }
+    }
+
+    SECTION("Off screen is invalid")
+    {
+        SyntheticGazeModel model = perfectModel();
+        model.right.offsetX = -1000.0;
+
+        SyntheticGazeGenerator gen(model, 100);
+        gen.next(truth, right, left);
+        CHECK(right.first == common::invalidCoord);
+        CHECK(right.second == common::invalidCoord);
+        CHECK(left == std::pair<unsigned int, unsigned int>(500, 400));
+    }
+}
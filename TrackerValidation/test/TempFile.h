@@ -0,0 +1,82 @@
+// A temporary file for tests and benchmarks, removed when it goes out of
+// scope. The file is created empty, so the name can't be taken by anyone
+// else in the meantime.
+
+#ifndef TEMPFILE_H
+#define TEMPFILE_H
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <cstdlib> // for mkstemp()
+#include <unistd.h> // for close()
+#endif
+
+class TempFile
+{
+  private:
+    std::string path;
+
+    // other files named after this one, to be removed with it
+    std::vector<std::string> siblings;
+
+  public:
+    // @throws std::runtime_error if the file couldn't be created
+    TempFile()
+    {
+#ifndef _WIN32
+        const char *dir = std::getenv("TMPDIR");
+        std::string pattern = std::string(dir != nullptr ? dir : "/tmp")
+                            + "/validatorXXXXXX";
+        std::vector<char> name(pattern.begin(), pattern.end());
+        name.push_back('\0');
+
+        const int fd = mkstemp(name.data());
+        if (fd == -1)
+        {
+            throw std::runtime_error("Could not create a temporary file in " + pattern);
+        }
+        close(fd);
+        path = name.data();
+#else
+        char name[L_tmpnam];
+        FILE *f = nullptr;
+        if (tmpnam_s(name, sizeof(name)) != 0 || fopen_s(&f, name, "wb") != 0)
+        {
+            throw std::runtime_error("Could not create a temporary file");
+        }
+        fclose(f);
+        path = name;
+#endif
+    }
+
+    ~TempFile()
+    {
+        std::remove(path.c_str());
+        for (const std::string &sibling : siblings)
+        {
+            std::remove(sibling.c_str());
+        }
+    }
+
+    TempFile(const TempFile &) = delete;
+    TempFile &operator=(const TempFile &) = delete;
+
+    const std::string &getPath() const
+    {
+        return path;
+    }
+
+    // The path with suffix added, e.g. for a file written alongside this
+    // one. It is removed along with this file.
+    std::string sibling(const std::string &suffix)
+    {
+        siblings.push_back(path + suffix);
+        return siblings.back();
+    }
+};
+
+#endif // not defined TEMPFILE_H
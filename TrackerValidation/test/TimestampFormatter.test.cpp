@@ -0,0 +1,95 @@
+#include "../TimestampFormatter.h"
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    // the slow way, for comparison
+    std::string reference(std::chrono::system_clock::time_point t)
+    {
+        const std::time_t ts = std::chrono::system_clock::to_time_t(
+            std::chrono::time_point_cast<std::chrono::seconds>(t));
+        struct tm buffer;
+#ifdef _WIN32
+        localtime_s(&buffer, &ts);
+#else
+        localtime_r(&ts, &buffer);
+#endif
+        std::ostringstream out;
+        out << std::put_time(&buffer, "%Y-%m-%d %H:%M:%S");
+        return out.str();
+    }
+}
+
+TEST_CASE("TimestampFormatter", "[TimestampFormatter]")
+{
+    // a whole second, so time_point_cast rounding doesn't matter
+    const std::chrono::system_clock::time_point base(std::chrono::seconds(1620000000));
+
+    SECTION("Microseconds")
+    {
+        TimestampFormatter formatter;
+
+        CHECK(formatter.format(base) == reference(base) + ".000000");
+        CHECK(formatter.format(base + std::chrono::microseconds(1234))
+              == reference(base) + ".001234");
+        CHECK(formatter.format(base + std::chrono::microseconds(999999))
+              == reference(base) + ".999999");
+
+        // the cached second moves on
+        const auto later = base + std::chrono::seconds(1) + std::chrono::microseconds(5);
+        CHECK(formatter.format(later) == reference(later) + ".000005");
+        const auto nextDay = base + std::chrono::hours(24);
+        CHECK(formatter.format(nextDay) == reference(nextDay) + ".000000");
+
+        // and back again
+        CHECK(formatter.format(base) == reference(base) + ".000000");
+    }
+
+    SECTION("Milliseconds")
+    {
+        TimestampFormatter formatter(TimestampFormatter::Resolution::Milliseconds);
+
+        CHECK(formatter.format(base + std::chrono::microseconds(12999))
+              == reference(base) + ".012");
+    }
+
+    SECTION("Into a buffer")
+    {
+        TimestampFormatter formatter;
+        char buffer[TimestampFormatter::maxLength];
+
+        const std::size_t length = formatter.format(base, buffer);
+        CHECK(length == 26);
+        CHECK(std::strlen(buffer) == length);
+    }
+
+    SECTION("Before the epoch")
+    {
+        TimestampFormatter formatter;
+        const std::chrono::system_clock::time_point t(-std::chrono::microseconds(1));
+
+        const std::chrono::system_clock::time_point second(-std::chrono::seconds(1));
+        CHECK(formatter.format(t) == reference(second) + ".999999");
+    }
+
+    SECTION("Epoch nanoseconds")
+    {
+        char buffer[TimestampFormatter::maxLength];
+
+        const auto t = base + std::chrono::microseconds(1234);
+        CHECK(TimestampFormatter::formatEpochNs(t, buffer) == 19);
+        CHECK(std::string(buffer) == "1620000000001234000");
+
+        const std::chrono::system_clock::time_point epoch;
+        CHECK(TimestampFormatter::formatEpochNs(epoch, buffer) == 1);
+        CHECK(std::string(buffer) == "0");
+    }
+}
@@ -0,0 +1,78 @@
+#include "../TrackerClock.h"
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+TEST_CASE("TrackerClock", "[TrackerClock]")
+{
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point t0 = Clock::now();
+
+    // difference between two host times, in ms
+    auto diffMs = [](Clock::time_point a, Clock::time_point b) {
+        return std::chrono::duration<double, std::milli>(a - b).count();
+    };
+
+    SECTION("No pairs yet")
+    {
+        TrackerClock clock(1000.0);
+        CHECK(clock.toHost(123.0) == Clock::time_point());
+        CHECK(clock.getSpan() == 0.0);
+    }
+
+    SECTION("Offset and drift with transport latency")
+    {
+        // tracker clock in ms, starting at 5000, running 100 ppm slow. Each
+        // sample takes 1-5 ms to arrive.
+        TrackerClock clock(1000.0);
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<double> latency(1.0, 5.0);
+
+        double worst = 0.0;
+        for (int i = 0; i < 20000; ++i)
+        {
+            double trueMs = i * 0.5; // 2 kHz
+            double trackerMs = 5000.0 + trueMs * (1.0 - 100e-6);
+            Clock::time_point taken = t0 + std::chrono::microseconds(
+                static_cast<long long>(trueMs * 1000.0));
+            Clock::time_point arrival = taken + std::chrono::microseconds(
+                static_cast<long long>(latency(rng) * 1000.0));
+
+            Clock::time_point estimate = clock.update(trackerMs, arrival);
+
+            // samples can't arrive before they were taken
+            CHECK(estimate <= arrival);
+
+            // the drift isn't estimated until we have a couple of seconds of
+            // data, so allow a bit longer than that to settle
+            if (i > 6000)
+            {
+                double err = std::fabs(diffMs(estimate, taken) - 1.0);
+                worst = (err > worst ? err : worst);
+            }
+        }
+
+        // the fastest sample took 1 ms, so that's where the estimate sits
+        CHECK(worst < 0.05);
+        CHECK(clock.getDriftPpm() == Approx(100.0).margin(5.0));
+        CHECK(clock.getSpan() == Approx(10.0).margin(0.1));
+    }
+
+    SECTION("Tracker clock restart")
+    {
+        TrackerClock clock(1.0); // seconds
+        for (int i = 0; i < 100; ++i)
+        {
+            clock.update(1000.0 + i * 0.01, t0 + std::chrono::milliseconds(10 * i));
+        }
+        CHECK(clock.getSpan() == Approx(0.99).margin(0.1));
+
+        // tracker restarted from zero
+        Clock::time_point arrival = t0 + std::chrono::seconds(2);
+        CHECK(clock.update(0.0, arrival) == arrival);
+        CHECK(clock.getSpan() == 0.0);
+    }
+}
@@ -0,0 +1,120 @@
+#include "../ValidationStats.h"
+
+#include "catch.hpp"
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    GazeWindowStats makeWindow(double rx, double ry, double lx, double ly,
+                               double rmsS2S, bool leftValid = true)
+    {
+        GazeWindowStats w;
+        w.right = EyeWindowStats{ 10, rx, ry, rx, ry, 1.0, 1.0, rmsS2S };
+        w.left = EyeWindowStats{ leftValid ? 10u : 0u, lx, ly, lx, ly, 1.0, 1.0, rmsS2S };
+        return w;
+    }
+}
+
+TEST_CASE("RunningStats", "[ValidationStats]")
+{
+    RunningStats stats;
+    CHECK(stats.getCount() == 0);
+    CHECK(stats.getMean() == 0.0);
+    CHECK(stats.getSD() == 0.0);
+
+    stats.add(5.0);
+    CHECK(stats.getMean() == 5.0);
+    CHECK(stats.getVariance() == 0.0);
+
+    // large offset, small spread
+    RunningStats offset;
+    for (double v : { 1e9 + 4.0, 1e9 + 7.0, 1e9 + 13.0, 1e9 + 16.0 })
+    {
+        offset.add(v);
+    }
+    CHECK(offset.getCount() == 4);
+    CHECK(offset.getMean() == 1e9 + 10.0);
+    CHECK(offset.getVariance() == Approx(30.0));
+
+    // 2 * t(3) * sd / sqrt(n)
+    CHECK(offset.getConfidenceWidth() == Approx(2.0 * 3.182 * std::sqrt(30.0) / 2.0));
+    CHECK(std::isinf(stats.getConfidenceWidth()));
+
+    // large samples use the normal distribution
+    RunningStats large;
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+        large.add(i % 2 == 0 ? 1.0 : -1.0);
+    }
+    CHECK(large.getConfidenceWidth() == Approx(2.0 * 1.96 * large.getSD() / 10.0));
+}
+
+TEST_CASE("ValidationStats", "[ValidationStats]")
+{
+    ValidationStats stats(4);
+    CHECK(stats.getTargetCount() == 4);
+
+    stats.add(1, 100, 100, makeWindow(103.0, 104.0, 97.0, 100.0, 2.0));
+    stats.add(1, 100, 100, makeWindow(97.0, 96.0, 97.0, 100.0, 4.0, false));
+    stats.add(3, 500, 200, makeWindow(500.0, 210.0, 500.0, 200.0, 2.0));
+
+    const EyeTargetStats &right = stats.getTarget(1, true);
+    CHECK(right.accuracy.getCount() == 2);
+    CHECK(right.accuracy.getMean() == 5.0);
+    CHECK(right.accuracy.getSD() == 0.0);
+    CHECK(right.offsetX.getMean() == 0.0);
+    CHECK(right.offsetX.getSD() == Approx(4.242641));
+    CHECK(right.getRmsS2S() == Approx(3.162278));
+
+    // the second left eye window had no data
+    const EyeTargetStats &left = stats.getTarget(1, false);
+    CHECK(left.accuracy.getCount() == 1);
+    CHECK(left.offsetX.getMean() == -3.0);
+
+    CHECK(stats.getTarget(0, true).accuracy.getCount() == 0);
+    CHECK(stats.getOverall(true).accuracy.getCount() == 3);
+    CHECK(stats.getOverall(true).accuracy.getMean() == Approx(20.0 / 3.0));
+    CHECK(stats.getOverall(false).accuracy.getCount() == 2);
+
+    CHECK_THROWS_AS(stats.add(4, 0, 0, makeWindow(0.0, 0.0, 0.0, 0.0, 0.0)),
+                    std::out_of_range);
+    CHECK_THROWS_AS(stats.getTarget(4, true), std::out_of_range);
+
+    std::ostringstream out;
+    stats.write(out);
+    const std::string summary = out.str();
+    CHECK(summary.find("1,\"Right\",2,0.00,0.00,4.24,5.66,5.00,0.00,3.16\n") != std::string::npos);
+    CHECK(summary.find("3,\"Right\",1,") != std::string::npos);
+    CHECK(summary.find("0,\"Right\"") == std::string::npos);
+    CHECK(summary.find("\"All\",\"Left\",2,") != std::string::npos);
+
+    // target 1: the left eye only has one value
+    CHECK(std::isinf(stats.getAccuracyWidth(1)));
+    CHECK(std::isinf(stats.getAccuracyWidth(0)));
+    stats.add(1, 100, 100, makeWindow(100.0, 105.0, 97.0, 100.0, 2.0));
+    CHECK(stats.getAccuracyWidth(1) == 0.0); // all errors are 5
+}
+
+TEST_CASE("ValidationStats in degrees", "[ValidationStats]")
+{
+    VisualAngleConverter converter(ScreenGeometry{ 1920, 1080, 530.0, 300.0, 600.0 });
+    converter.setTarget(0, 960.0, 540.0);
+
+    ValidationStats stats(1, &converter);
+    CHECK(std::string(stats.getUnits()) == "degrees");
+
+    stats.add(0, 960, 540, makeWindow(1000.0, 540.0, 960.0, 540.0, 10.0));
+
+    double degX, degY;
+    converter.toDegrees(0, 40.0, 0.0, degX, degY);
+    CHECK(stats.getTarget(0, true).accuracy.getMean() == Approx(degX));
+    CHECK(stats.getTarget(0, true).offsetX.getMean() == Approx(degX));
+    CHECK(stats.getTarget(0, true).getRmsS2S() == Approx(converter.distanceToDegrees(0, 10.0)));
+    CHECK(stats.getTarget(0, false).accuracy.getMean() == 0.0);
+
+    CHECK(std::string(ValidationStats(1).getUnits()) == "pixels");
+}
@@ -19,9 +19,28 @@ TEST_CASE("ValidatorConfig", "[ValidatorConfig]")
         CHECK(config.tracker == "mouse");
         CHECK(config.subject == "Test user");
         CHECK(config.outputFile == "");
+        CHECK(config.outputSync == 0);
+        CHECK(config.recordFile == "");
+        CHECK(config.measureWindow == 250);
+        CHECK(config.fixationMethod == "ivt");
+        CHECK(config.fixationThreshold == 0.0);
+        CHECK(config.screenWidth == 0.0);
+        CHECK(config.screenHeight == 0.0);
+        CHECK(config.viewingDistance == 0.0);
+        CHECK(config.stopWidth == 0.0);
+        CHECK(config.minRepeats == 2);
+        CHECK(config.dwellTime == 0);
+        CHECK(config.dwellRadius == 50.0);
+        CHECK(config.minReactionTime == 0.0);
         CHECK(config.preview == false);
+        CHECK(config.headless == false);
         CHECK(config.trackerConfig.ipAddress == "127.0.0.1");
         CHECK(config.trackerConfig.ipPort == 4242);
+        CHECK(config.trackerConfig.sampleRate == 0);
+        CHECK(config.trackerConfig.replayFile == "");
+        CHECK(config.trackerConfig.replaySpeed == 1.0);
+        CHECK(config.trackerConfig.synthetic.seed == SyntheticGazeModel().seed);
+        CHECK(config.trackerConfig.synthetic.blinkRate == SyntheticGazeModel().blinkRate);
     }
 
     SECTION("Other constructor values")
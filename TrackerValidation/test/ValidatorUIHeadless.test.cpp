@@ -0,0 +1,135 @@
+#include "../ValidatorUIHeadless.h"
+
+#include "../DisplayGeometry.h"
+#include "../Validator.h"
+#include "../ValidatorConfig.h"
+
+#include "catch.hpp"
+#include "TempFile.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    // keeps the validator's console output out of the test results
+    class QuietCout
+    {
+      private:
+        std::ostringstream sink;
+        std::streambuf *original;
+
+      public:
+        QuietCout() : original(std::cout.rdbuf(sink.rdbuf())) {}
+        ~QuietCout() { std::cout.rdbuf(original); }
+    };
+
+    // measurements written to a data file
+    unsigned int countRows(const std::string &path, const std::string &label)
+    {
+        std::ifstream in(path);
+        const std::string prefix = "\"" + label + "\",";
+        unsigned int rows = 0;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.compare(0, prefix.size(), prefix) == 0)
+            {
+                ++rows;
+            }
+        }
+        return rows;
+    }
+
+    unsigned int timerCalls = 0;
+    ValidatorUIHeadless *stopAfter = nullptr;
+    void countTimer()
+    {
+        if (++timerCalls == 3)
+        {
+            stopAfter->stop();
+        }
+    }
+}
+
+TEST_CASE("ValidatorUIHeadless", "[ValidatorUIHeadless]")
+{
+    const std::pair<unsigned int, unsigned int> res(800, 600);
+
+    SECTION("Timer and display geometry")
+    {
+        ValidatorUIHeadless ui(10, "circle", res);
+        CHECK(DisplayGeometry::get().getResolution() == res);
+        CHECK(ui.inTestRoutine() == false);
+
+        timerCalls = 0;
+        stopAfter = &ui;
+        ui.setTimerFunc(&countTimer, 4);
+        ui.run();
+
+        CHECK(timerCalls == 3);
+        CHECK(ui.getTickCount() == 3);
+        CHECK(ui.getSimulatedTime() == 12);
+        CHECK(ui.getClickCount() == 0); // no targets to click
+        CHECK(ui.inTestRoutine() == false);
+    }
+
+    SECTION("Bad setup")
+    {
+        CHECK_THROWS_AS(ValidatorUIHeadless(10, "circle", std::make_pair(0u, 600u)),
+                        std::runtime_error);
+
+        ValidatorUIHeadless ui(10, "circle", res);
+        CHECK_THROWS_AS(ui.run(), std::runtime_error);
+    }
+
+    SECTION("Whole sessions")
+    {
+        TempFile tmp;
+        const std::string &tmpFile = tmp.getPath();
+        tmp.sibling(".summary.csv"); // written at the end of the session
+
+        ValidatorConfig config(4, 3, 2);
+        config.tracker = "synthetic";
+        config.outputFile = tmpFile;
+        config.headless = true;
+
+        SECTION("Clicking every target")
+        {
+            ValidatorUIHeadless *ui = new ValidatorUIHeadless(config.targetSize,
+                                                              config.targType, res);
+            {
+                QuietCout quiet;
+                Validator v(config);
+                v.startUI(ui); // returns when every target is done
+
+                // one click and one frame for each measurement
+                CHECK(ui->getClickCount() == 24);
+                CHECK(ui->getFrameCount() >= 24);
+                CHECK(ui->getDisplayLatency().getCount() == 24);
+            }
+
+            CHECK(countRows(tmpFile, config.trackerLabel) == 24);
+        }
+
+        SECTION("Scripted misses")
+        {
+            ValidatorUIHeadless *ui = new ValidatorUIHeadless(config.targetSize,
+                                                              config.targType, res);
+            ui->click(std::make_pair(0u, 0u));
+            ui->click(std::make_pair(799u, 599u));
+            {
+                QuietCout quiet;
+                Validator v(config);
+                v.startUI(ui);
+
+                CHECK(ui->getClickCount() == 26);
+            }
+
+            CHECK(countRows(tmpFile, config.trackerLabel) == 24);
+        }
+    }
+}
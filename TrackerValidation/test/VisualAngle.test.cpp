@@ -0,0 +1,72 @@
+#include "../VisualAngle.h"
+
+#include "catch.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+TEST_CASE("VisualAngle", "[VisualAngle]")
+{
+    // 1920x1080, 530x300 mm screen at 600 mm
+    const ScreenGeometry geometry{ 1920, 1080, 530.0, 300.0, 600.0 };
+
+    SECTION("Invalid geometry")
+    {
+        CHECK(geometry.isValid());
+        CHECK(!ScreenGeometry({ 1920, 1080, 530.0, 300.0, 0.0 }).isValid());
+        CHECK_THROWS_AS(VisualAngleConverter(ScreenGeometry{ 0, 1080, 530.0, 300.0, 600.0 }),
+                        std::runtime_error);
+    }
+
+    VisualAngleConverter converter(geometry);
+    const double mmPerPx = 530.0 / 1920.0;
+
+    SECTION("Exact angles")
+    {
+        CHECK(converter.angleBetween(100.0, 100.0, 100.0, 100.0) == 0.0);
+
+        // from the middle of the screen to the right edge
+        const double expected = std::atan(960.0 * mmPerPx / 600.0) * 180.0 / 3.14159265358979;
+        CHECK(converter.angleBetween(959.5, 539.5, 1919.5, 539.5) == Approx(expected));
+    }
+
+    SECTION("Precomputed conversion matches the exact angle")
+    {
+        // centre, edge and corner targets
+        const double targets[][2] = { { 959.5, 539.5 }, { 1800.0, 540.0 },
+                                      { 100.0, 60.0 }, { 1900.0, 1000.0 } };
+        const double offsets[][2] = { { 20.0, 0.0 }, { 0.0, -20.0 },
+                                      { 30.0, 30.0 }, { -5.0, 12.0 } };
+
+        for (unsigned int t = 0; t < 4; ++t)
+        {
+            converter.setTarget(t, targets[t][0], targets[t][1]);
+        }
+        REQUIRE(converter.getTargetCount() == 4);
+
+        for (unsigned int t = 0; t < 4; ++t)
+        {
+            for (const auto &offset : offsets)
+            {
+                double degX, degY;
+                converter.toDegrees(t, offset[0], offset[1], degX, degY);
+
+                const double exact = converter.angleBetween(
+                    targets[t][0], targets[t][1],
+                    targets[t][0] + offset[0], targets[t][1] + offset[1]);
+                CHECK(std::sqrt(degX * degX + degY * degY) == Approx(exact).epsilon(0.01));
+            }
+        }
+
+        // at the centre, a pixel is about atan(mmPerPx / distance)
+        double degX, degY;
+        converter.toDegrees(0, 1.0, 0.0, degX, degY);
+        CHECK(degX == Approx(mmPerPx / 600.0 * 180.0 / 3.14159265358979).epsilon(0.001));
+        CHECK(degY == Approx(0.0).margin(1e-9));
+
+        // and less towards the edge
+        CHECK(converter.distanceToDegrees(1, 1.0) < converter.distanceToDegrees(0, 1.0));
+
+        CHECK_THROWS_AS(converter.toDegrees(4, 1.0, 1.0, degX, degY), std::out_of_range);
+    }
+}